@@ -4,7 +4,8 @@
  *   by David Sanz Kirbis
  *
  *  Defines ports and pins used to connect an omnivision sensor+al422 
- *  fifo camera module to an ATmega 328p Pro Mini Arduino clone board.
+ *  fifo camera module to an ATmega 328p Pro Mini or a Mega2560 Arduino
+ *  clone board.
  *  The module tested with this setup has a 12MHz clock connected to
  *  the sensor XCLK and the following header / pinout:
  *
@@ -38,6 +39,19 @@
  *                banding due to the reduction of depth but it is
  *                fair enough for detection purposes. 
  *
+ *  2016 June 21 - Modified pin mapping for Mega2560
+ *
+ *  The pin mapping of each board is a port traits struct (board_328p,
+ *  board_mega2560) selected by the target MCU, so the very same sources
+ *  build for both boards: this sketch is the firmware of the Mega too,
+ *  built with the Mega 2560 board selected (arduvision_02_mega only holds
+ *  its host sketch and wiring).
+ *  The masks are constexpr and the register accessors are forced inline
+ *  (always_inline, plain inline is only a hint) to a constant address, so
+ *  SET_RCLK_H and friends below still compile to single sbi/cbi/in
+ *  instructions on I/O space ports (PORTH on the Mega is in extended I/O
+ *  space, as it always was: lds/ori/sts).
+ *
  *
  *   Wire the module as follows:
  *
@@ -75,6 +89,27 @@
  *       FIFO_D7  ------  PD7/D7
  *
  *
+ *   WARNING!!!! : sensor works at 3.3V USE A VOLTAGE LEVEL TRANSLATOR
+ *
+ *       OV+FIFO  -----------------------  ATMEGA 2560 (3.3V/8MHz)
+ *
+ *           GND  -----------------------  GND
+ *          3.3v  -----------------------  3.3v
+ *       FIFO_OE  ---------------------->  GND
+ *      FIFO_WEN  --> level tranlator -->  PH5 / D8
+ *     FIFO_RCLK  --> level tranlator -->  PH6 / D9 /PWM
+ *     FIFO_WRST  --> level tranlator -->  PB6 / D12
+ *     FIFO_RRST  --> level tranlator -->  PB7 / D13
+ *        OV_SDA  <-> level tranlator <->  PD1 / SDA
+ *        OV_SCL  <-> level tranlator <->  PD0 / SCL
+ *      OV_VSYNC  <-- level tranlator <--  PE4 / D2
+ *       FIFO_D3  <-- level tranlator <--  PF3 / A3
+ *       FIFO_D4  <-- level tranlator <--  PF4 / A4
+ *       FIFO_D5  <-- level tranlator <--  PF5 / A5
+ *       FIFO_D6  <-- level tranlator <--  PF6 / A6
+ *       FIFO_D7  <-- level tranlator <--  PF7 / A7
+ *
+ *
  *
  ********************************************/
 
@@ -84,80 +119,117 @@
 #include <avr/io.h>
 
 
-// data pins --------------------
-
-#define DATA_DDR	    DDRD
-#define DATA_PORT	    PORTD
-#define DATA_PINS	    PIND
-
-// control pins --------------------
-#define VSYNC_INT 0 
+// board port traits --------------------
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+
+struct board_mega2560 {
+    // control pins (the data pins take the whole port)
+    static constexpr uint8_t VSYNC = _BV(PINE4);  // INT4, Arduino interrupt 0
+    static constexpr uint8_t WREN  = _BV(PINH5);  // Write Enable (active low)
+    static constexpr uint8_t RCLK  = _BV(PINH6);  // Read clock
+    static constexpr uint8_t WRST  = _BV(PINB6);  // Write Reset (active low)
+    static constexpr uint8_t RRST  = _BV(PINB7);  // Read Reset (active low)
+
+    static inline __attribute__((always_inline)) volatile uint8_t &dataPin()   { return PINF; }
+    static inline __attribute__((always_inline)) volatile uint8_t &dataDdr()   { return DDRF; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncPin()  { return PINE; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncDdr()  { return DDRE; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncPort() { return PORTE; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrenDdr()   { return DDRH; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrenPort()  { return PORTH; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkDdr()   { return DDRH; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkPort()  { return PORTH; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkPin()   { return PINH; }  // write 1s: toggle
+    static inline __attribute__((always_inline)) volatile uint8_t &wrstDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrstPort()  { return PORTB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rrstDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rrstPort()  { return PORTB; }
+
+    // the other pins of these ports are wired to the rest of the board
+    static inline __attribute__((always_inline)) void resetPorts() {}
+};
+typedef board_mega2560 board_t;
+
+#elif defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+
+struct board_328p {
+    // control pins (the data pins take the whole port)
+    static constexpr uint8_t VSYNC = _BV(PIND2);  // INT0
+    static constexpr uint8_t WREN  = _BV(PINB0);  // Write Enable (active low)
+    static constexpr uint8_t RCLK  = _BV(PINB1);  // Read clock
+    static constexpr uint8_t WRST  = _BV(PINB4);  // Write Reset (active low)
+    static constexpr uint8_t RRST  = _BV(PINB5);  // Read Reset (active low)
+
+    static inline __attribute__((always_inline)) volatile uint8_t &dataPin()   { return PIND; }
+    static inline __attribute__((always_inline)) volatile uint8_t &dataDdr()   { return DDRD; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncPin()  { return PIND; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncDdr()  { return DDRD; }
+    static inline __attribute__((always_inline)) volatile uint8_t &vsyncPort() { return PORTD; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrenDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrenPort()  { return PORTB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkPort()  { return PORTB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rclkPin()   { return PINB; }  // write 1s: toggle
+    static inline __attribute__((always_inline)) volatile uint8_t &wrstDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &wrstPort()  { return PORTB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rrstDdr()   { return DDRB; }
+    static inline __attribute__((always_inline)) volatile uint8_t &rrstPort()  { return PORTB; }
+
+    // reset registers and register directions
+    static inline __attribute__((always_inline)) void resetPorts() { DDRB = DDRD = PORTB = PORTD = 0; }
+};
+typedef board_328p board_t;
+
+// FIFO_RCLK is on OC1A: Timer1 can clock the fifo in hardware (see fifo_readRowHw)
+#define BOARD_HW_RCLK
+#define HW_RCLK_DATA_PIN    PIND
 
-#ifdef VSYNC_INT
-  #define OV_VSYNC            _BV(PIND2) 
 #else
-  #define OV_VSYNC            _BV(PINB0) 
+  #error "IO_config.h: no pin mapping for this board"
 #endif
 
-#define FIFO_WREN          _BV(PINB0)          // Write Enable (active low) 
-#define FIFO_RCLK          _BV(PINB1)          // Read clock
-#define FIFO_WRST          _BV(PINB4)          // Write Reset (active low)
-#define FIFO_RRST          _BV(PINB5)          // Read Reset (active low)
-
-#define WREN_DDR          DDRB
-#define WREN_PORT         PORTB
-
-#define RCLK_DDR          DDRB
-#define RCLK_PORT         PORTB
-
-#define WRST_DDR          DDRB
-#define WRST_PORT         PORTB
+// data pins --------------------
 
-#define RRST_DDR          DDRB
-#define RRST_PORT         PORTB
+#define DATA_DDR	    board_t::dataDdr()
+#define DATA_PINS	    board_t::dataPin()
 
-#ifdef VSYNC_INT
-  #define VSYNC_PIN         PIND
-  #define VSYNC_DDR         DDRD
-  #define VSYNC_PORT        PORTD
-#else
-  #define VSYNC_PIN         PINB
-  #define VSYNC_DDR         DDRB
-  #define VSYNC_PORT        PORTB
-#endif
+// control pins --------------------
+#define VSYNC_INT 0 // Arduino interrupt number of the VSYNC pin
 
-#define GET_VSYNC          (VSYNC_PIN & OV_VSYNC) 
+#define GET_VSYNC          (board_t::vsyncPin() & board_t::VSYNC) 
 
-#define DISABLE_RRST        RRST_PORT|=FIFO_RRST
-#define ENABLE_RRST          RRST_PORT&=~FIFO_RRST 
+#define DISABLE_RRST        board_t::rrstPort() |= board_t::RRST
+#define ENABLE_RRST         board_t::rrstPort() &= ~board_t::RRST 
 
-#define DISABLE_WRST        WRST_PORT|=FIFO_WRST
-#define ENABLE_WRST          WRST_PORT&=~FIFO_WRST 
+#define DISABLE_WRST        board_t::wrstPort() |= board_t::WRST
+#define ENABLE_WRST         board_t::wrstPort() &= ~board_t::WRST 
 
-#define SET_RCLK_H            RCLK_PORT|=FIFO_RCLK   
-#define SET_RCLK_L          RCLK_PORT&=~FIFO_RCLK
+#define SET_RCLK_H          board_t::rclkPort() |= board_t::RCLK   
+#define SET_RCLK_L          board_t::rclkPort() &= ~board_t::RCLK
+// Writing a one to a PINx bit toggles the PORTx bit: a plain store (out,
+// 1 cycle with the mask in a register), no read-modify-write. Used to
+// clock out the bytes that are not needed, see fifo_skipBytes().
+#define TOGGLE_RCLK(mask)   board_t::rclkPin() = (mask)
 
-#define ENABLE_WREN         WREN_PORT |= FIFO_WREN
-#define DISABLE_WREN         WREN_PORT &= ~FIFO_WREN
+#define ENABLE_WREN         board_t::wrenPort() |= board_t::WREN
+#define DISABLE_WREN        board_t::wrenPort() &= ~board_t::WREN
 
 
 // *************************************
 void static inline setup_IO_ports() {
   
-  // reset registers and register directions
-  DDRB = DDRD = PORTB = PORTD = 0;
+  board_t::resetPorts();
   // set fifo data pins as inputs 
   DATA_DDR  = 0;  // set pins as INPUTS
   
-  WREN_DDR  |= FIFO_WREN; // set pin as OUTPUT
-  RCLK_DDR  |= FIFO_RCLK; // set pin as OUTPUT
-  RRST_DDR  |= FIFO_RRST; // set pin as OUTPUT
-  WRST_DDR  |= FIFO_WRST; // set pin as OUTPUT
+  board_t::wrenDdr() |= board_t::WREN; // set pin as OUTPUT
+  board_t::rclkDdr() |= board_t::RCLK; // set pin as OUTPUT
+  board_t::rrstDdr() |= board_t::RRST; // set pin as OUTPUT
+  board_t::wrstDdr() |= board_t::WRST; // set pin as OUTPUT
   
-  VSYNC_DDR &= ~(OV_VSYNC); // set pin as INPUT
-#ifdef VSYNC_INT
-  VSYNC_PORT |= OV_VSYNC; // enable pullup (for interruption handler)
-#endif
+  board_t::vsyncDdr() &= ~board_t::VSYNC; // set pin as INPUT
+  board_t::vsyncPort() |= board_t::VSYNC; // enable pullup (for interruption handler)
 }
 
 
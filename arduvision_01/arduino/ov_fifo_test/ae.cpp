@@ -0,0 +1,108 @@
+
+#include "ae.h"
+#include "fifo.h"
+#include "sensor.h"
+
+
+static uint8_t  aeTarget   = 0;  // 0: the sensor's own AEC/AGC is in charge
+static uint16_t aeExposure = 0;  // line periods
+static uint8_t  aeGain     = 16; // 1/16 steps (16 = 1x)
+static uint8_t  aeDirty    = 0;  // new values waiting for ae_apply()
+
+//**************************
+// target = 0 gives the control back to the sensor
+void ae_setTarget(uint8_t target)
+{
+    if (target != 0 && aeTarget == 0) {
+        // start from wherever the sensor AEC left it, so there is no jump
+        sensor_setAutoExposure(0);
+        aeExposure = sensor_getExposure();
+        aeGain = sensor_getGain();
+        if (aeExposure == 0) aeExposure = 1;
+    }
+    else if (target == 0 && aeTarget != 0) {
+        sensor_setAutoExposure(1);
+        aeDirty = 0;
+    }
+    aeTarget = target;
+}
+//**************************
+uint8_t ae_getTarget(void)
+{
+    return aeTarget;
+}
+//**************************
+void ae_clearStats(void)
+{
+    memset(lumHist, 0, sizeof(lumHist));
+    lumAccumOn = aeTarget != 0;
+}
+//**************************
+// Compute new exposure/gain from the histogram of the last readout pass.
+// Returns 1 if the sensor registers have to be updated.
+uint8_t ae_update(void)
+{
+    uint16_t nPix = 0;
+    uint32_t lumSum = 0;
+    uint8_t  i;
+
+    if (aeTarget == 0) return 0;
+
+    for (i = 0; i < LUM_HIST_BINS; i++) {
+        nPix += lumHist[i];
+        lumSum += (uint32_t)lumHist[i] * ((i << 5) + 16); // bin centre
+    }
+    if (nPix == 0) return 0; // nothing was read in this pass (i.e. fps request)
+
+    uint8_t mean = lumSum / nPix;
+    // more than 1/32 of the pixels in the top bin: highlights are clipping
+    uint8_t bClipping = lumHist[LUM_HIST_BINS-1] > (nPix >> 5);
+
+    // total exposure (time * gain) in 1/16 steps
+    uint32_t total = (uint32_t)aeExposure * aeGain;
+    uint32_t newTotal;
+
+    if (bClipping && mean > (aeTarget >> 1)) {
+        newTotal = total - (total >> 2);
+    }
+    else if ((mean + AE_DEADBAND < aeTarget) || (mean > aeTarget + AE_DEADBAND)) {
+        if (mean == 0) mean = 1;
+        newTotal = (total * aeTarget) / mean;
+        // limit the step to x2 or /2 per frame to avoid oscillations
+        if (newTotal > (total << 1)) newTotal = total << 1;
+        if (newTotal < (total >> 1)) newTotal = total >> 1;
+    }
+    else return 0;
+
+    // use as much exposure time as the frame allows, then analog gain
+    uint16_t maxExposure = sensor_getMaxExposure();
+    uint16_t exposure = newTotal >> 4;
+    if (exposure > maxExposure) exposure = maxExposure;
+    if (exposure == 0) exposure = 1;
+    uint32_t gain = newTotal / exposure;
+    if (gain < 16) gain = 16;
+    if (gain > AE_MAX_GAIN) gain = AE_MAX_GAIN;
+
+    if (exposure == aeExposure && gain == aeGain) return 0;
+    aeExposure = exposure;
+    aeGain = gain;
+    aeDirty = 1;
+    return 1;
+}
+//**************************
+// The sensor latches AEC/gain changes at the next frame start, so this
+// can run anytime between two readouts.
+void ae_apply(void)
+{
+    uint16_t exposure;
+    uint8_t gain;
+
+    if (!aeDirty || aeTarget == 0) return;
+    noInterrupts(); // ae_update() runs in the VSYNC handler
+    exposure = aeExposure;
+    gain = aeGain;
+    aeDirty = 0;
+    interrupts();
+    sensor_setExposure(exposure);
+    sensor_setGain(gain);
+}
@@ -0,0 +1,36 @@
+/*******************************************************************
+ *
+ *   Part of the ARDUVISION project
+ *
+ *   by David Sanz Kirbis
+ *
+ *  Auto exposure loop run by the MCU instead of the sensor's AEC/AGC,
+ *  which hunts on high contrast scenes and breaks threshold based
+ *  tracking. It is fed by the luminance histogram the fifo readout
+ *  kernels fill while clocking out any frame (see lumHist in fifo.h),
+ *  so no extra pass nor image transfer to the host is needed.
+ *
+ *  Usage: ae_clearStats() before a readout pass (it also turns the
+ *  kernels' counting off while the sensor is in charge), ae_update()
+ *  after it (cheap, safe inside the VSYNC handler) and ae_apply() from
+ *  the main loop, as it writes the sensor registers through I2C (Wire
+ *  needs interrupts enabled).
+ *
+ ********************************************/
+
+#ifndef _AE_H
+#define _AE_H
+
+#include <Arduino.h>
+
+static const uint8_t AE_DEFAULT_TARGET = 110; // mean Y to settle at
+static const uint8_t AE_DEADBAND       = 8;   // +/- levels around the target with no correction
+static const uint8_t AE_MAX_GAIN       = 128; // 8x, in 1/16 steps
+
+void ae_setTarget(uint8_t target);
+uint8_t ae_getTarget(void);
+void ae_clearStats(void);
+uint8_t ae_update(void);
+void ae_apply(void);
+
+#endif /* _AE_H */
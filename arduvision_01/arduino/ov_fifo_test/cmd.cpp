@@ -0,0 +1,60 @@
+
+#include "cmd.h"
+#include "stats.h"
+
+static cmd_t volatile cmdQueue[CMD_QUEUE_LEN];
+static uint8_t volatile cmdHead = 0;     // written by the producer (RX side) only
+static uint8_t volatile cmdTail = 0;     // written by the consumer (main loop) only
+
+static uint8_t rxState = 0;              // bytes of the current frame received
+static uint8_t rxOp, rxTag, rxArgL, rxArgH;
+
+//**************************
+// Feeds one received byte to the parser. Called from the RX interrupt,
+// or from the main loop for serial drivers without an RX hook.
+void cmd_rxByte(uint8_t value)
+{
+    switch (rxState) {
+        case 0: if (value != CMD_SYNC) return; // hunt for the frame start
+                break;
+        case 1: rxOp = value;
+                break;
+        case 2: rxTag = value;
+                break;
+        case 3: rxArgL = value;
+                break;
+        case 4: rxArgH = value;
+                break;
+        default: {
+                rxState = 0;
+                uint8_t next = (cmdHead + 1) & (CMD_QUEUE_LEN - 1);
+                if (value != (CMD_SYNC ^ rxOp ^ rxTag ^ rxArgL ^ rxArgH) ||
+                    rxOp == 0 || rxOp >= CMD_NUM_OPS || next == cmdTail) {
+                    STATS_INC(rxOverflows);
+                    return;
+                }
+                cmdQueue[cmdHead].op = rxOp;
+                cmdQueue[cmdHead].tag = rxTag;
+                cmdQueue[cmdHead].arg = ((uint16_t)rxArgH << 8) | rxArgL;
+                cmdHead = next; // publish after the entry is complete
+                return;
+        }
+    }
+    rxState++;
+}
+//**************************
+// Copies the oldest queued command, without removing it
+boolean cmd_peek(cmd_t &cmd)
+{
+    uint8_t tail = cmdTail;
+    if (tail == cmdHead) return false;
+    cmd.op = cmdQueue[tail].op;
+    cmd.tag = cmdQueue[tail].tag;
+    cmd.arg = cmdQueue[tail].arg;
+    return true;
+}
+//**************************
+void cmd_pop(void)
+{
+    if (cmdTail != cmdHead) cmdTail = (cmdTail + 1) & (CMD_QUEUE_LEN - 1);
+}
@@ -0,0 +1,68 @@
+/*******************************************************************
+ *
+ *   Part of the ARDUVISION project
+ *
+ *   by David Sanz Kirbis
+ *
+ *  Binary command protocol. Every command is a fixed 6 byte frame:
+ *
+ *     CMD_SYNC, opcode, tag, arg low byte, arg high byte, check
+ *
+ *  with check = CMD_SYNC ^ opcode ^ tag ^ arg low ^ arg high. The tag is
+ *  chosen by the host and echoed in the header of the reply to a frame
+ *  request, so several requests can be in flight at once. The frames are
+ *  parsed one byte at a time by cmd_rxByte(), a small state machine with
+ *  constant cost per byte meant to run in the RX interrupt, so commands
+ *  are taken in even while a frame is being sent. Complete frames go to
+ *  a bounded queue emptied by the main loop (cmd_peek / cmd_pop).
+ *  Frames with a bad check or opcode, or that find the queue full, are
+ *  dropped and counted in stats.rxOverflows; a stray byte just makes the parser hunt for the
+ *  next CMD_SYNC.
+ *
+ ********************************************/
+
+#ifndef _CMD_H
+#define _CMD_H
+
+#include <Arduino.h>
+
+static const uint8_t CMD_SYNC      = 0xA5;
+// Power of 2, one slot kept empty. The main loop takes no commands while
+// the VSYNC handler sends a frame, so this holds the worst host burst of
+// that time: a refill of the host pipeline (CMD_THRESH, CMD_SEND and a
+// second CMD_SEND) plus a 3 command colour window, with one spare.
+static const uint8_t CMD_QUEUE_LEN = 8;
+
+enum cmdOp_t {
+    CMD_HELLO = 1,  // replies "Hello to you too!"
+    CMD_SEND,       // arg: serialRequest_t, frame or row packing to send (queued)
+    CMD_DARK,       // arg: threshold, darkest blob bounding box (queued)
+    CMD_BRIG,       // arg: threshold, brightest blob bounding box (queued)
+    CMD_THRESH,     // arg: threshold for the next requests
+    CMD_RATE,       // arg: frameRate_t profile, replies the measured fps
+    CMD_STATS,      // replies the stats_t record
+    CMD_AE,         // arg: mean Y target, 0 back to the sensor AEC/AGC
+    CMD_HWRCLK,     // arg: hwRclkMode_t mask, modes read with the hardware RCLK engine
+    CMD_DECIM,      // arg: decimation factor (1, 2, 4, 8), bit 8 2x2 box average, for the next requests
+    CMD_STILL,      // arg: 1 capture a QVGA still and hold it in the fifo (replies the header), 0 release it
+    CMD_TILE,       // arg: tile x | tile y << 8, replies fH rows of fW YUYV pixels of the held still
+    CMD_TARGET_FPS, // arg: frame rate the SEND_ADAPTIVE requests pick their packing for, 0 richest
+    CMD_COLOR_U,    // arg: min | max << 8, "U" range of the SEND_COLOR window
+    CMD_COLOR_V,    // arg: min | max << 8, "V" range of the SEND_COLOR window
+    CMD_COLOR_Y,    // arg: min | max << 8, "Y" range of the SEND_COLOR window
+    CMD_SIG,        // arg: signature (0 to 6) | 1 << 8 to take the SEND_COLOR window, | 0 to clear it
+    CMD_MORPH,      // arg: morphMode_t, 3x3 cleaning of the SEND_8PPB mask and SEND_DARK, for the next requests
+    CMD_NUM_OPS
+};
+
+struct cmd_t {
+    uint8_t  op;
+    uint8_t  tag;
+    uint16_t arg;
+};
+
+void cmd_rxByte(uint8_t value);
+boolean cmd_peek(cmd_t &cmd);
+void cmd_pop(void);
+
+#endif /* _CMD_H */
@@ -1,6 +1,9 @@
 
 #include "fifo.h"
 
+uint16_t lumHist[LUM_HIST_BINS];
+uint8_t lumAccumOn = 0;
+
 
 void fifo_loadFrame(void)
 {
@@ -3,6 +3,20 @@
 #include "IO_config.h"
 #include "delay.h"
 
+// Luminance histogram filled for free by the readout kernels below, from the
+// Y bytes they clock out anyway. Each bin spans 32 levels. Cleared and
+// evaluated once per frame by the auto exposure loop (see ae.h).
+// Counting only runs while lumAccumOn is set: ae_clearStats() sets it when
+// the loop is enabled, and requests reading the frame more than once drop
+// it after the first pass so the 16 bit bins don't wrap. Each kernel takes
+// a register copy with LUM_GATE, so with AE off a pixel costs a test and a
+// branch instead of the RAM increment (~15 cycles).
+#define LUM_HIST_BINS 8
+extern uint16_t lumHist[LUM_HIST_BINS];
+extern uint8_t lumAccumOn;
+#define LUM_GATE      const uint8_t lumOn = lumAccumOn
+#define LUM_ACCUM(y)  do { if (lumOn) lumHist[(y) >> 5]++; } while (0)
+
 void fifo_loadFrame(void);
 
 void fifo_rrst(void);
@@ -14,139 +28,667 @@ uint8_t fifo_readBytes(uint8_t *destBuf, unsigned long nBytes);
 
 void fifo_sendSerialBytes(Stream &destPort, unsigned long nBytes);
 
+// Output of the row kernels: they call put() once per output byte, so the
+// same kernel fills a RAM row buffer or, with the lean UART driver, writes
+// straight to the UART data register (see uart_sink in uart.h), overlapping
+// the fifo readout with the transmission and saving the row buffer copy.
+struct fifo_bufSink {
+    uint8_t *pos;
+    fifo_bufSink(uint8_t *buf) : pos(buf) {}
+    inline void put(uint8_t value) __attribute__((always_inline)) { *pos++ = value; }
+};
+
 // --------------------------------------
-void  __inline__ fifo_skipBytes(unsigned long nBytes)
+// Seek: clock out bytes without reading them, two PINx toggles per byte
+// (RCLK idles low). The AL422 needs a 20ns read cycle with 7ns RCLK high
+// and low times at least, and a toggle store lasts one CPU cycle (125ns
+// at 8MHz, 62.5ns at 16MHz; 2 cycles on the Mega, PINH is not in I/O
+// space), so back to back toggles are within spec and no padding is
+// needed. fifo_skipBytes() unrolls 8 bytes per pass with a 16 bit
+// countdown (covers the whole 384KB fifo): ~2.5 cycles per byte on the
+// 328p, against ~24 with the old delayed loop and ~4 for sbi/cbi.
+#define RCLK_PULSE(mask)    do { TOGGLE_RCLK(mask); TOGGLE_RCLK(mask); } while (0)
+
+static __inline__ __attribute__((always_inline)) void fifo_skipByte(void)
 {
-    while (nBytes > 0) {
-        SET_RCLK_H;
-        _delay_cycles(10);
-        SET_RCLK_L;
-        _delay_cycles(10);
-        nBytes--;
+    RCLK_PULSE(board_t::RCLK);
+}
+
+static __inline__ void fifo_skipBytes(unsigned long nBytes)
+{
+    uint8_t mask = board_t::RCLK; // kept in a register for the plain stores
+
+    for (uint8_t n = nBytes & 7; n; n--)
+        RCLK_PULSE(mask);
+    for (uint16_t n = nBytes >> 3; n; n--) {
+        RCLK_PULSE(mask); RCLK_PULSE(mask); RCLK_PULSE(mask); RCLK_PULSE(mask);
+        RCLK_PULSE(mask); RCLK_PULSE(mask); RCLK_PULSE(mask); RCLK_PULSE(mask);
     }
 }
+// Short gaps, like the bytes between decimated pixels: no set up cost.
+static __inline__ __attribute__((always_inline)) void fifo_skipFew(uint8_t nBytes)
+{
+    uint8_t mask = board_t::RCLK;
+    for (; nBytes; nBytes--) RCLK_PULSE(mask);
+}
 // --------------------------------------
-static __inline__ void fifo_readRow0ppb(uint8_t* _rowStart, uint8_t* _rowEnd)
+template <class Sink>
+static __inline__ void fifo_readRow0ppb(Sink &out, unsigned int nBytes)
 {
-    while (_rowStart != _rowEnd) {
+    LUM_GATE;
+    uint8_t yValue;
+    nBytes >>= 1;
+    while (nBytes--) {
+      // "Y" byte
       SET_RCLK_H;
-      *_rowStart++ = DATA_PINS;
-      //_delayNanoseconds(5);
+      yValue = DATA_PINS;
       SET_RCLK_L;
-      //_delayNanoseconds(5);
+      out.put(yValue);
+      LUM_ACCUM(yValue);
+      // "U/V" byte
+      SET_RCLK_H;
+      yValue = DATA_PINS;
+      SET_RCLK_L;
+      out.put(yValue);
     }
 }
 // --------------------------------------
-static __inline__ void fifo_readRow1ppb(uint8_t* _rowStart, uint8_t* _rowEnd)
+template <class Sink>
+static __inline__ void fifo_readRow1ppb(Sink &out, unsigned int nBytes)
 {
-   while (_rowStart != _rowEnd) {
+   LUM_GATE;
+   uint8_t yValue;
+   while (nBytes--) {
       SET_RCLK_H;
-      *_rowStart = DATA_PINS >> 4;
+      yValue = DATA_PINS;
       //_delayNanoseconds(5);
       SET_RCLK_L;
+      LUM_ACCUM(yValue);
+      yValue >>= 4;
       //_delayNanoseconds(5);
       SET_RCLK_H;
-      *_rowStart++ |= DATA_PINS & 0xf0;
+      yValue |= DATA_PINS & 0xf0;
       //_delayNanoseconds(5);
       SET_RCLK_L;
       //_delayNanoseconds(5);
+      out.put(yValue);
    }
 }
 // --------------------------------------
-static __inline__ void fifo_readRow2ppb(uint8_t* _rowStart, uint8_t* _rowEnd)
+// Decimated luminance rows: the "Y" byte of every factor-th pixel, nPix
+// of them, skipping the rest (nPix * factor pixels are clocked out).
+// With Box each output is the mean of the two "Y" bytes of the sampled
+// YUYV pair, and Below also averages in above[] (the Box output of the
+// previous row, nPix bytes; it may be the buffer being written): the 2x2
+// box average of the pixels sampled. factor >= 2 with Box.
+template <bool Box, bool Below, class Sink>
+static __inline__ void fifo_readRowDecim(Sink &out, const uint8_t *above, uint8_t nPix, uint8_t factor)
 {
-    uint8_t pixValue = 0;
-    uint8_t dataValue = 0;
-    while (_rowStart != _rowEnd) {
+    LUM_GATE;
+    uint8_t gap = Box ? (factor - 2) * 2 : factor * 2 - 1; // bytes after the sample
+    uint8_t yValue;
+    while (nPix--) {
+        SET_RCLK_H;
+        yValue = DATA_PINS;
+        SET_RCLK_L;
+        LUM_ACCUM(yValue);
+        if (Box) {
+            fifo_skipByte(); // "U" byte
+            SET_RCLK_H;
+            uint8_t y1 = DATA_PINS;
+            SET_RCLK_L;
+            LUM_ACCUM(y1);
+            fifo_skipByte(); // "V" byte
+            yValue = ((uint16_t)yValue + y1 + 1) >> 1;
+            if (Below) yValue = ((uint16_t)yValue + *above++ + 1) >> 1;
+        }
+        out.put(yValue);
+        fifo_skipFew(gap);
+    }
+}
+// --------------------------------------
+// Packed luminance rows: Bits per pixel, pixels packed LSB first into a
+// continuous bit stream (pixel 0 in the low bits of the first byte), so
+// 1, 2 and 4 bits give the old 8, 4 and 2 pixels per byte layouts, and
+// odd depths straddle bytes (3 bits: 8 pixels in 3 bytes, 5 bits: 8 pixels
+// in 5 bytes). Only D7..D3 are wired, so 5 bits is all the data there is.
+// Mode PACK_THRESH gives 1 bit per pixel, set if (Y & 0xF8) > thresh, and
+// PACK_PLANE the bit plane selected by the mask in thresh (1 bit per pixel
+// too, set if Y & thresh).
+//
+// A group is the smallest run of pixels ending on a byte boundary. It is
+// unrolled at compile time by fifo_packPixel below: every shift, mask and
+// byte emission is a constant, leaving just the clocking, one shift/or per
+// pixel and one put() per output byte. nBytes must be a whole number of
+// groups (it is for any frame width multiple of 8).
+template <bool Wide> struct fifo_packAcc       { typedef uint8_t  type; };
+template <>          struct fifo_packAcc<true> { typedef uint16_t type; }; // pixels straddle bytes
 
-      SET_RCLK_H;
-      pixValue = DATA_PINS >> 4;
-      SET_RCLK_L;
+enum fifo_packMode_t {
+    PACK_LUMA,   // the Bits most significant bits of Y
+    PACK_THRESH, // Y over a threshold
+    PACK_PLANE   // one bit plane of Y
+};
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+template <uint8_t Bits, fifo_packMode_t Mode, uint8_t Pix, uint8_t NPix>
+struct fifo_packPixel {
+    typedef typename fifo_packAcc<(8 % Bits) != 0>::type acc_t;
+    static const uint8_t SHIFT = (Pix * Bits) & 7;
 
-      SET_RCLK_H;
-      pixValue |= (DATA_PINS & 0xF0);
-      SET_RCLK_L;
+    template <class Sink>
+    static __inline__ __attribute__((always_inline)) void read(Sink &out, acc_t acc, uint8_t thresh, uint8_t lumOn)
+    {
+        uint8_t yValue;
+        // "Y" byte
+        SET_RCLK_H;
+        yValue = DATA_PINS;
+        SET_RCLK_L;
+        LUM_ACCUM(yValue);
+        if (Mode == PACK_THRESH)     acc |= (acc_t)((yValue & 0xF8) > thresh) << SHIFT;
+        else if (Mode == PACK_PLANE) acc |= (acc_t)((yValue & thresh) != 0) << SHIFT;
+        else                         acc |= (acc_t)(yValue >> (8 - Bits)) << SHIFT;
+        fifo_skipByte(); // "U/V" byte
+        if (SHIFT + Bits >= 8) {
+            out.put((uint8_t)acc);
+            acc = (8 % Bits) ? (acc_t)(acc >> 8) : 0;
+        }
+        fifo_packPixel<Bits, Mode, Pix + 1, NPix>::read(out, acc, thresh, lumOn);
+    }
+};
+template <uint8_t Bits, fifo_packMode_t Mode, uint8_t NPix>
+struct fifo_packPixel<Bits, Mode, NPix, NPix> {
+    template <class Sink, class acc_t>
+    static __inline__ __attribute__((always_inline)) void read(Sink &, acc_t, uint8_t, uint8_t) {}
+};
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+template <uint8_t Bits, fifo_packMode_t Mode, class Sink>
+static __inline__ void fifo_readRowPacked(Sink &out, unsigned int nBytes, uint8_t thresh)
+{
+    LUM_GATE;
+    static const uint8_t GROUP_PIX   = 8 / (Bits & -Bits); // lcm(8, Bits) / Bits
+    static const uint8_t GROUP_BYTES = GROUP_PIX * Bits / 8;
 
-      *_rowStart++ = pixValue;
-    }
+    for (nBytes /= GROUP_BYTES; nBytes; nBytes--)
+        fifo_packPixel<Bits, Mode, 0, GROUP_PIX>::read(out, 0, thresh, lumOn);
 }
 // --------------------------------------
-static __inline__ void fifo_readRow4ppb(uint8_t* _rowStart, uint8_t* _rowEnd)
+// First and last pixel set in a byte of a 1 bit row (pixel 0 in bit 0),
+// 7 and 0 for none. Constant expressions, so they can be checked at
+// compile time.
+static constexpr uint8_t fifo_firstPix(uint8_t bits, uint8_t i = 0)
 {
-    uint8_t pixValue = 0;
-    uint8_t dataValue = 0;
-    while (_rowStart != _rowEnd) {
+    return (i == 7 || ((bits >> i) & 1)) ? i : fifo_firstPix(bits, i + 1);
+}
+static constexpr uint8_t fifo_lastPix(uint8_t bits, uint8_t i = 7)
+{
+    return (i == 0 || ((bits >> i) & 1)) ? i : fifo_lastPix(bits, i - 1);
+}
+#ifdef BOARD_HW_RCLK
+// --------------------------------------
+// Experimental readout engine: Timer1 toggles RCLK on OC1A in hardware
+// (CTC mode, one fifo byte every HW_RCLK_PERIOD cycles) and a cycle
+// locked loop samples the "Y" bytes in phase, ~6 cycles after their
+// rising edge (AL422 access time is 15ns), 2 cycles before the "U/V" one.
+// Timer1 is stopped after the falling edge that follows the last "U/V"
+// byte and only then disconnected from the pin, so the OC1A latch is
+// left low (the next call starts without a spurious edge) and exactly
+// nBytes fifo bytes are read; nBytes / 2 "Y" bytes are stored.
+// No RMW instructions per byte: each pass reads two pixels, and the
+// cycles spent waiting for the first "U/V" byte poll the UART receiver,
+// in constant time. Bytes received are stored at rxBuf, their number
+// returned in nRx; the loop takes 32 cycles per pass, so one poll per
+// pass keeps up with any UART rate up to F_CPU * 10 / 32 bps. rxBuf needs
+// one spare byte: the poll stores even when nothing came.
+//
+// Timer1 is borrowed: the caller must save and restore the timebase
+// (returned: approximate cycles it was taken) and keep interrupts
+// disabled, as any delay breaks the lock. nBytes a multiple of 4.
+static const uint8_t HW_RCLK_PERIOD   = 8;  // cycles per fifo byte, as timed by the loop below
+static const uint8_t HW_RCLK_PASS     = 4 * HW_RCLK_PERIOD; // cycles per pass, one UART poll
+static const uint8_t HW_RCLK_OVERHEAD = 40; // timer setup and restore, cycles
 
-      SET_RCLK_H;
-      pixValue = DATA_PINS >> 6;
-      SET_RCLK_L;
+static __inline__ uint16_t fifo_readRowHw(uint8_t *buf, unsigned int nBytes, uint8_t *rxBuf, uint8_t &nRx)
+{
+    uint8_t tmp, status;
+    uint8_t start = _BV(WGM12) | _BV(CS10); // CTC, clk/1
+    uint8_t *rx = rxBuf;
+    unsigned int n = nBytes >> 2;
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+    TCCR1B = 0;
+    TCCR1A = _BV(COM1A1);           // clear OC1A on match,
+    TCCR1C = _BV(FOC1A);            // forced now: the first toggle is a rising edge
+    TCCR1A = _BV(COM1A0);           // toggle OC1A on match
+    OCR1A  = HW_RCLK_PERIOD / 2 - 1;
+    TCNT1  = 0;
 
-      SET_RCLK_H;
-      pixValue |= (DATA_PINS & 0xC0) >> 4;
-      SET_RCLK_L;
+    asm volatile (
+        "sts %[tccr1b], %[start]      \n\t" // first rising edge ~4 cycles later
+        ".rept 9 \n\t nop \n\t .endr  \n\t" // sample 2 cycles before the next edge
+        "1: in %[tmp], %[pin]         \n\t" // "Y" byte
+        "st X+, %[tmp]                \n\t"
+        "lds %[status], %[ucsr0a]     \n\t" // UART poll, 10 cycles either way:
+        "sbrc %[status], %[rxc0]      \n\t" // skipping the 2 word lds takes
+        "lds %[tmp], %[udr0]          \n\t" // as long as running it
+        "st Z, %[tmp]                 \n\t" // stored anyway, kept if RXC0 was set:
+        "lsl %[status]                \n\t" // RXC0 (bit 7) to carry
+        "adc r30, __zero_reg__        \n\t"
+        "adc r31, __zero_reg__        \n\t"
+        ".rept 3 \n\t nop \n\t .endr  \n\t" // "U/V" byte edge meanwhile
+        "in %[tmp], %[pin]            \n\t" // "Y" byte
+        "st X+, %[tmp]                \n\t"
+        "sbiw %[n], 1                 \n\t"
+        "breq 2f                      \n\t"
+        ".rept 8 \n\t nop \n\t .endr  \n\t" // "U/V" byte edge meanwhile
+        "rjmp 1b                      \n\t"
+        "2: sts %[tccr1b], __zero_reg__ \n\t" // between the last falling edge and the next rising one
+        "sts %[tccr1a], __zero_reg__  \n\t" // OC1A low, now disconnected
+        : [tmp] "=&r" (tmp), [status] "=&r" (status), [n] "+w" (n), "+x" (buf), "+z" (rx)
+        : [start] "r" (start), [pin] "I" (_SFR_IO_ADDR(HW_RCLK_DATA_PIN)),
+          [ucsr0a] "n" (_SFR_MEM_ADDR(UCSR0A)), [udr0] "n" (_SFR_MEM_ADDR(UDR0)), [rxc0] "I" (RXC0),
+          [tccr1a] "n" (_SFR_MEM_ADDR(TCCR1A)), [tccr1b] "n" (_SFR_MEM_ADDR(TCCR1B))
+        : "memory"
+    );
+    nRx = rx - rxBuf;
+    return nBytes * HW_RCLK_PERIOD + HW_RCLK_OVERHEAD;
+}
+#endif
+// --------------------------------------------
+// --------------------------------------------
+static __inline__ void fifo_getBrig(uint8_t* _rowStart, uint8_t _frW,  uint8_t _frH, uint8_t _border, uint8_t _thresh)
+{
+  
+}
+// --------------------------------------------
+// Bounding box of the pixels darker than thresh inside the window
+// x0 <= x < x1, y0 <= y < y1 (frame pixels), sampling every step-th pixel
+// of every step-th row and skipping the rest. The read pointer must be at
+// the start of the frame. Returns false if no sample matched, otherwise
+// fills box[] with x0, y0, x1, y1 of the matching samples.
+static __inline__ boolean fifo_findDark(uint8_t *box, uint8_t frW, uint8_t x0, uint8_t y0,
+                                        uint8_t x1, uint8_t y1, uint8_t step, uint8_t thresh)
+{
+  LUM_GATE;
+  uint8_t pix;
+  uint8_t bx0 = 255, by0 = 255, bx1 = 0, by1 = 0;
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+  if (x1 <= x0 || y1 <= y0) return false;
+  uint8_t nPix = (x1 - x0 + step - 1) / step;
+  uint8_t lastX = x0 + (nPix - 1) * step;
+  uint8_t gap = step * 2 - 1; // "U/V" byte and the pixels up to the next sample
+  // from the "U/V" byte of the last sample of a row to the first of the next one
+  unsigned int lineSkip = (unsigned int)(frW - lastX - 1 + x0) * 2 + 1
+                        + (unsigned int)(step - 1) * frW * 2;
 
-      SET_RCLK_H;
-      pixValue |= (DATA_PINS & 0xC0) >> 2;
-      SET_RCLK_L;
+  fifo_skipBytes(((unsigned int)y0 * frW + x0) * 2);
+  for (uint8_t j = y0; ; ) {
+      uint8_t i = x0;
+      for (uint8_t k = nPix; ; ) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(pix);
+          if (pix < thresh) {
+              if (i < bx0) bx0 = i;
+              if (i > bx1) bx1 = i;
+              if (by0 == 255) by0 = j; // first time only
+              by1 = j;
+          }
+          if (--k == 0) break;
+          fifo_skipFew(gap);
+          i += step;
+      }
+      j += step;
+      if (j >= y1) break;
+      fifo_skipBytes(lineSkip);
+  }
+  if (by0 == 255) return false;
+  box[0] = bx0;
+  box[1] = by0;
+  box[2] = bx1;
+  box[3] = by1;
+  return true;
+}
+// --------------------------------------------
+// Laser line, see fifo_getLaserLine(): the peak pending since the row
+// above (row in the high byte, pixel above it in the low one) refined by
+// the parabola through that pixel, the peak and the one below, to
+// row * 256 + offset, the offset within +-128 (half a row).
+static __inline__ uint16_t fifo_laserSubPixel(uint16_t pending, uint8_t peak, uint8_t below)
+{
+  uint8_t above = pending & 0xFF;
+  uint16_t row = pending & 0xFF00;
+  int16_t curv = 2 * (int16_t)peak - above - below;
+  int16_t offset = 0;
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+  if (curv > 0) {
+      offset = (((int16_t)below - above) << 7) / curv;
+      if (offset > 128) offset = 128;
+      else if (offset < -128) offset = -128;
+  }
+  if (offset < 0 && row < (uint16_t)-offset) return 0; // above the first row
+  return row + offset;
+}
+// --------------------------------------------
+// For every column, the row of its brightest "Y" (brighter than minPeak)
+// to sub-pixel, as row * 256 + offset, 0xFFFF for none: a line laser
+// profile in one pass from the start of the frame. Each column keeps its
+// brightest value so far in peak[] and the previous row in prev[] (frW
+// bytes each); a new peak waits in pos[] for the row below it.
+static __inline__ void fifo_getLaserLine(uint16_t *pos, uint8_t *peak, uint8_t *prev,
+                                         uint8_t frW, uint8_t frH, uint8_t minPeak)
+{
+  LUM_GATE;
+  uint8_t pix;
 
-      SET_RCLK_H;
-      pixValue |= DATA_PINS & 0xC0;      
-      SET_RCLK_L;
+  memset(peak, minPeak, frW);
+  memset(pos, 0xFF, frW * sizeof(uint16_t));
+  for (uint8_t j = 0; j < frH; j++) {
+      uint8_t pending = j ? j - 1 : 0xFE; // row of the peaks refined with this one
+      for (uint8_t i = 0; i < frW; i++) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(pix);
+          if ((uint8_t)(pos[i] >> 8) == pending) pos[i] = fifo_laserSubPixel(pos[i], peak[i], pix);
+          if (pix > peak[i]) {
+              peak[i] = pix;
+              pos[i] = ((uint16_t)j << 8) | (j ? prev[i] : pix);
+          }
+          prev[i] = pix;
+          fifo_skipByte(); // "U/V" byte
+      }
+  }
+  // peaks on the last row, with no row below
+  for (uint8_t i = 0; i < frW; i++)
+      if ((uint8_t)(pos[i] >> 8) == frH - 1) pos[i] &= 0xFF00;
+}
+// --------------------------------------------
+// Brightest "Y" of the frame, one pass from its start. at[] gets the
+// middle of the longest horizontal run at that value (x, y), the first
+// one on ties: the middle of a saturated spot rather than its top left
+// pixel, and inside it even if something else saturates too (a midpoint
+// of the first and last occurrence would fall between the two).
+static __inline__ uint8_t fifo_findPeak(uint8_t *at, uint8_t frW, uint8_t frH)
+{
+  LUM_GATE;
+  uint8_t pix;
+  uint8_t peak = 0;
+  uint8_t run = 0, best = 0; // peak pixels ending at this one, longest run so far
+  uint8_t xEnd = 0, y = 0;   // where the longest run ends
 
-      SET_RCLK_H;
-      SET_RCLK_L;
+  for (uint8_t j = 0; j < frH; j++) {
+      run = 0;
+      for (uint8_t i = 0; i < frW; i++) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(pix);
+          if (pix >= peak) {
+              if (pix > peak) {
+                  peak = pix;
+                  run = best = 0;
+              }
+              if (++run > best) {
+                  best = run;
+                  xEnd = i;
+                  y = j;
+              }
+          }
+          else run = 0;
+          fifo_skipByte(); // "U/V" byte
+      }
+  }
+  at[0] = xEnd - ((best - 1) >> 1);
+  at[1] = y;
+  return peak;
+}
+// --------------------------------------------
+// Centroid of the "Y" over floor, weighted by how much they are over it,
+// in the window of +-radius pixels around (cx, cy) clipped to the frame.
+// The read pointer must be at the start of the frame. xy[] gets x and y
+// times 256, (cx, cy) if no pixel is over floor.
+static __inline__ void fifo_spotCentroid(uint16_t *xy, uint8_t frW, uint8_t frH,
+                                         uint8_t cx, uint8_t cy, uint8_t radius, uint8_t floor)
+{
+  uint8_t pix;
+  uint8_t x0 = cx > radius ? cx - radius : 0;
+  uint8_t y0 = cy > radius ? cy - radius : 0;
+  uint8_t x1 = cx + radius < frW ? cx + radius + 1 : frW;
+  uint8_t y1 = cy + radius < frH ? cy + radius + 1 : frH;
+  uint16_t sumW = 0;
+  int32_t sumX = 0, sumY = 0; // relative to (cx, cy)
 
-      *_rowStart++ = pixValue;
-    }
+  fifo_skipBytes(((unsigned int)y0 * frW + x0) * 2);
+  for (uint8_t j = y0; ; ) {
+      for (uint8_t i = x0; i < x1; i++) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          if (pix > floor) {
+              uint8_t w = pix - floor;
+              sumW += w;
+              sumX += (int16_t)w * (int8_t)(i - cx);
+              sumY += (int16_t)w * (int8_t)(j - cy);
+          }
+          fifo_skipByte(); // "U/V" byte
+      }
+      if (++j >= y1) break;
+      fifo_skipBytes((unsigned int)(frW - x1 + x0) * 2);
+  }
+  xy[0] = (uint16_t)cx << 8;
+  xy[1] = (uint16_t)cy << 8;
+  if (sumW == 0) return;
+  xy[0] += (sumX << 8) / sumW;
+  xy[1] += (sumY << 8) / sumW;
 }
-// --------------------------------------
-static __inline__ void fifo_readRow8ppb(uint8_t* _rowStart, uint8_t* _rowEnd, uint8_t thresh)
+// --------------------------------------------
+// Projection profiles: the sum of "Y" of every row (frH words) and of
+// every column (frW words), one pass from the start of the frame.
+static __inline__ void fifo_getProjections(uint16_t *rowSum, uint16_t *colSum, uint8_t frW, uint8_t frH)
 {
-    uint8_t pixValue = 0;
-    uint8_t bitIndex = 0;
-    
-    while (_rowStart != _rowEnd ) {
-        //read "Y" byte
-        SET_RCLK_H;
-        pixValue |= (((DATA_PINS  & 0xF8) > thresh) << bitIndex);
-        SET_RCLK_L;
-        
-        // skip "U/V" byte
-        SET_RCLK_H;
-        SET_RCLK_L;
-        bitIndex++;
-        if (bitIndex == 8) {
-           *_rowStart++ = pixValue;
-           bitIndex = 0;
-           pixValue = 0;
-        }
-     
-    }
+  LUM_GATE;
+  uint8_t pix;
+
+  memset(colSum, 0, frW * sizeof(uint16_t));
+  for (uint8_t j = 0; j < frH; j++) {
+      uint16_t sum = 0;
+      uint16_t *col = colSum;
+      for (uint8_t i = frW; i; i--) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(pix);
+          sum += pix;
+          *col++ += pix;
+          fifo_skipByte(); // "U/V" byte
+      }
+      rowSum[j] = sum;
+  }
 }
 // --------------------------------------------
+// Line following: for every row, the centre column of its longest run of
+// "Y" darker than thresh, 0xFF if it is shorter than minRun pixels. One
+// pass from the start of the frame, frH bytes in centre[].
+static __inline__ void fifo_getLineCentres(uint8_t *centre, uint8_t frW, uint8_t frH,
+                                           uint8_t thresh, uint8_t minRun)
+{
+  LUM_GATE;
+  uint8_t pix;
+
+  for (uint8_t j = 0; j < frH; j++) {
+      uint8_t run = 0, start = 0;
+      uint8_t best = 0, bestStart = 0;
+      for (uint8_t i = 0; i < frW; i++) {
+          SET_RCLK_H;
+          pix = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(pix);
+          if (pix < thresh) {
+              if (run++ == 0) start = i;
+          }
+          else if (run) {
+              if (run > best) {
+                  best = run;
+                  bestStart = start;
+              }
+              run = 0;
+          }
+          fifo_skipByte(); // "U/V" byte
+      }
+      if (run > best) { // run up to the right edge
+          best = run;
+          bestStart = start;
+      }
+      centre[j] = best >= minRun ? bestStart + ((best - 1) >> 1) : 0xFF;
+  }
+}
 // --------------------------------------------
-static __inline__ void fifo_getBrig(uint8_t* _rowStart, uint8_t _frW,  uint8_t _frH, uint8_t _border, uint8_t _thresh)
+// Colour window: "U", "V" and mean "Y" ranges (inclusive) a YUYV
+// macro-pixel must fall in.
+struct fifo_colorWin_t {
+    uint8_t uMin, uMax;
+    uint8_t vMin, vMax;
+    uint8_t yMin, yMax;
+};
+// --------------------------------------------
+// Colour blob: bounding box, area and centroid of the macro-pixels (2
+// pixels sharing "U" and "V") inside win, one pass from the start of the
+// frame. out[] gets x0, y0, x1, y1 as fifo_getDark(), then the area in
+// pixels (little endian word) and the centroid x, y; all 0 if none.
+static __inline__ void fifo_getColor(uint8_t *out, uint8_t frW, uint8_t frH, const fifo_colorWin_t &win)
 {
-  
+  LUM_GATE;
+  uint8_t y0, u, y1, v;
+  uint8_t bx0 = 255, by0 = 255, bx1 = 0, by1 = 0;
+  uint8_t uSpan = win.uMax - win.uMin; // one unsigned compare per range
+  uint8_t vSpan = win.vMax - win.vMin;
+  uint8_t ySpan = win.yMax - win.yMin;
+  uint16_t area = 0; // macro-pixels
+  uint32_t sumX = 0, sumY = 0;
+
+  for (uint8_t j = 0; j < frH; j++) {
+      for (uint8_t i = 0; i < frW; i += 2) {
+          SET_RCLK_H;
+          y0 = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          u = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          y1 = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          v = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(y0);
+          LUM_ACCUM(y1);
+          if ((uint8_t)(u - win.uMin) <= uSpan && (uint8_t)(v - win.vMin) <= vSpan &&
+              (uint8_t)((((uint16_t)y0 + y1) >> 1) - win.yMin) <= ySpan) {
+              if (i < bx0) bx0 = i;
+              if (i > bx1) bx1 = i;
+              if (by0 == 255) by0 = j; // first time only
+              by1 = j;
+              area++;
+              sumX += i;
+              sumY += j;
+          }
+      }
+  }
+  memset(out, 0, 8);
+  if (area == 0) return;
+  out[0] = bx0;
+  out[1] = by0;
+  out[2] = bx1 + 1; // right pixel of the macro-pixel
+  out[3] = by1;
+  out[4] = (area << 1) & 0xFF;
+  out[5] = (area << 1) >> 8;
+  out[6] = sumX / area + 1; // between the two pixels, rounded up
+  out[7] = sumY / area;
+}
+// --------------------------------------------
+// Colour signatures: one bit per signature in a lookup table per
+// channel, indexed by the value in bins of 1 << FIFO_SIG_SHIFT levels, so
+// a macro-pixel is tested against all of them with three lookups ANDed.
+static const uint8_t FIFO_SIG_MAX   = 7;
+static const uint8_t FIFO_SIG_SHIFT = 3;
+static const uint8_t FIFO_SIG_BINS  = 256 >> FIFO_SIG_SHIFT;
+struct fifo_sigLut_t {
+    uint8_t u[FIFO_SIG_BINS];
+    uint8_t v[FIFO_SIG_BINS];
+    uint8_t y[FIFO_SIG_BINS];
+};
+// --------------------------------------------
+// Sets (win != 0) or clears the bits of signature sig in lut
+static __inline__ void fifo_sigSet(fifo_sigLut_t &lut, uint8_t sig, const fifo_colorWin_t *win)
+{
+  uint8_t bit = 1 << sig;
+
+  for (uint8_t b = 0; b < FIFO_SIG_BINS; b++) {
+      lut.u[b] &= ~bit;
+      lut.v[b] &= ~bit;
+      lut.y[b] &= ~bit;
+      if (win == 0) continue;
+      if (b >= (win->uMin >> FIFO_SIG_SHIFT) && b <= (win->uMax >> FIFO_SIG_SHIFT)) lut.u[b] |= bit;
+      if (b >= (win->vMin >> FIFO_SIG_SHIFT) && b <= (win->vMax >> FIFO_SIG_SHIFT)) lut.v[b] |= bit;
+      if (b >= (win->yMin >> FIFO_SIG_SHIFT) && b <= (win->yMax >> FIFO_SIG_SHIFT)) lut.y[b] |= bit;
+  }
+}
+// --------------------------------------------
+// Bounding box and area of the macro-pixels of every signature in lut,
+// one pass from the start of the frame. out[] gets FIFO_SIG_MAX records
+// of x0, y0, x1, y1 and the area in pixels (little endian word), all 0
+// for the signatures not found.
+static __inline__ void fifo_getSignatures(uint8_t *out, uint8_t frW, uint8_t frH, const fifo_sigLut_t &lut)
+{
+  LUM_GATE;
+  uint8_t y0, u, y1, v;
+  uint8_t box[FIFO_SIG_MAX][4];
+  uint16_t area[FIFO_SIG_MAX]; // macro-pixels
+
+  memset(box, 0, sizeof(box));
+  memset(area, 0, sizeof(area));
+  for (uint8_t j = 0; j < frH; j++) {
+      for (uint8_t i = 0; i < frW; i += 2) {
+          SET_RCLK_H;
+          y0 = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          u = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          y1 = DATA_PINS;
+          SET_RCLK_L;
+          SET_RCLK_H;
+          v = DATA_PINS;
+          SET_RCLK_L;
+          LUM_ACCUM(y0);
+          LUM_ACCUM(y1);
+          uint8_t match = lut.u[u >> FIFO_SIG_SHIFT] & lut.v[v >> FIFO_SIG_SHIFT] &
+                          lut.y[(((uint16_t)y0 + y1) >> 1) >> FIFO_SIG_SHIFT];
+          for (uint8_t k = 0; match; k++, match >>= 1) {
+              if (!(match & 1)) continue;
+              uint8_t *b = box[k];
+              if (area[k]++ == 0) {
+                  b[0] = b[2] = i;
+                  b[1] = j;
+              }
+              else if (i < b[0]) b[0] = i;
+              else if (i > b[2]) b[2] = i;
+              b[3] = j;
+          }
+      }
+  }
+  for (uint8_t k = 0; k < FIFO_SIG_MAX; k++, out += 6) {
+      memcpy(out, box[k], 4);
+      if (area[k]) out[2]++; // right pixel of the macro-pixel
+      out[4] = (area[k] << 1) & 0xFF;
+      out[5] = (area[k] << 1) >> 8;
+  }
 }
 // --------------------------------------------
 static __inline__ void fifo_getDark(uint8_t* _rowStart, uint8_t _frW,  uint8_t _frH, uint8_t _border, uint8_t _thresh)
 {
+  LUM_GATE;
   uint8_t i = 0;
   uint8_t j = 0;
   uint8_t pix = 255;
@@ -169,17 +711,14 @@ static __inline__ void fifo_getDark(uint8_t* _rowStart, uint8_t _frW,  uint8_t _
             SET_RCLK_H;
             pix = DATA_PINS;
             SET_RCLK_L;
+            LUM_ACCUM(pix);
             if (pix < _thresh) {
               if (i > x1) x1 = i;
               else if (i < x0) x0 = i;
               if (y0 == 255) y0 = j; // first time only, y0 = 255
               y1 = j;
             }
-            // skip "U/v" byte
-            SET_RCLK_H;
-            _delayNanoseconds(5);
-            SET_RCLK_L;
-            _delayNanoseconds(5);
+            fifo_skipByte(); // "U/V" byte
      } 
      fifo_skipBytes(skipBytesX2);
   } 
@@ -302,6 +302,9 @@
 #define OV7670_REG_HAECC7	0xaa	/* Hist AEC/AGC control 7 */
 #define OV7670_REG_BD60MAX	0xab	/* 60hz banding step limit */
 
+#define OV7670_REG_ADVFL	0x2d	/* dummy lines inserted in vertical blanking, LSB */
+#define OV7670_REG_ADVFH	0x2e	/* dummy lines inserted in vertical blanking, MSB */
+
 
 const struct regval_list qqvga_yuv_ov7670[] PROGMEM = {
 
@@ -513,6 +516,66 @@ const struct regval_list common_reglist_ov7670[] PROGMEM = {//from the linux dri
 	{ 0xff, 0xff }	// END MARKER
 };
 
+// --------------------------------------------
+// frame rate profiles, with 12MHz XCLK:
+// internal clock = XCLK * PLL / (2 * (CLKRC + 1)), 24MHz gives 30fps.
+// Dummy lines stretch the frame (and the maximum exposure time) without
+// touching the pixel clock, so the fifo write rate stays the same.
+
+const struct regval_list rate60_ov7670[] PROGMEM = {
+      {OV7670_REG_CLKRC, CLKRC_0}, {OV7670_REG_DBLV, DBLV_X8}, // 48MHz
+      {OV7670_REG_ADVFL, 0x00}, {OV7670_REG_ADVFH, 0x00},
+      { 0xff, 0xff }	// END MARKER
+};
+
+const struct regval_list rate30_ov7670[] PROGMEM = {
+      {OV7670_REG_CLKRC, CLKRC_2}, {OV7670_REG_DBLV, DBLV_X8}, // 24MHz
+      {OV7670_REG_ADVFL, 0x00}, {OV7670_REG_ADVFH, 0x00},
+      { 0xff, 0xff }	// END MARKER
+};
+
+const struct regval_list rate15_ov7670[] PROGMEM = {
+      {OV7670_REG_CLKRC, CLKRC_4}, {OV7670_REG_DBLV, DBLV_X8}, // 12MHz
+      {OV7670_REG_ADVFL, 0x00}, {OV7670_REG_ADVFH, 0x00},
+      { 0xff, 0xff }	// END MARKER
+};
+
+// 15fps timing plus 510 dummy lines: ~7.5fps, twice the exposure range
+const struct regval_list rateLongExp_ov7670[] PROGMEM = {
+      {OV7670_REG_CLKRC, CLKRC_4}, {OV7670_REG_DBLV, DBLV_X8}, // 12MHz
+      {OV7670_REG_ADVFL, 0xfe}, {OV7670_REG_ADVFH, 0x01},
+      { 0xff, 0xff }	// END MARKER
+};
+
+// --------------------------------------------
+// output size only (downsampling and pixel clock divider), to switch
+// formats at run time without touching the rate, exposure or colour
+// settings. Values as in the format lists above.
+
+const struct regval_list qvga_scale_ov7670[] PROGMEM = {
+      {OV7670_REG_COM14, COM14_DCWEN | COM14_DCW_MSCL | COM14_PCLK_DIV_2}, // divide by 2
+      {OV7670_REG_SCALING_DCWCTR, SCALING_DCWCTR_2}, // downsample by 2
+      {OV7670_REG_COM3, COM3_DCWEN},
+      {OV7670_REG_SCALING_PCLK_DIV, 0xf0 | SCALING_PCLK_DIV_2}, // divide by 2
+      { 0xff, 0xff }	// END MARKER
+};
+
+const struct regval_list qqvga_scale_ov7670[] PROGMEM = {
+      {OV7670_REG_COM14, 0x1a}, // divide by 4
+      {OV7670_REG_SCALING_DCWCTR, 0x22}, // downsample by 4
+      {OV7670_REG_COM3, 0x04},
+      {OV7670_REG_SCALING_PCLK_DIV, 0xf2}, // divide by 4
+      { 0xff, 0xff }	// END MARKER
+};
+
+const struct regval_list qqqvga_scale_ov7670[] PROGMEM = {
+      {OV7670_REG_COM14, COM14_DCWEN | COM14_PCLK_DIV_8 }, // divide by 8
+      {OV7670_REG_SCALING_DCWCTR, SCALING_DCWCTR_8}, // downsample by 8
+      {OV7670_REG_COM3, COM3_DCWEN},
+      {OV7670_REG_SCALING_PCLK_DIV, SCALING_PCLK_DIV_8}, // divide by 8
+      { 0xff, 0xff }	// END MARKER
+};
+
   
 #endif /* _OV7670_REGS_H */
 
@@ -485,8 +485,67 @@ const struct regval_list common_reglist_ov772x[] PROGMEM =
 {0x8d, 0x20},
 {0xff, 0xff}	// END MARKER
 };
-  
 
+
+// --------------------------------------------
+// frame rate profiles: CLKRC 00/01/03/07 for 60/30/15/7.5fps, with the
+// banding filter steps (0x22, 0x23) matching each rate.
+// Dummy lines stretch the frame (and the maximum exposure time) without
+// touching the pixel clock, so the fifo write rate stays the same.
+
+const struct regval_list rate60_ov772x[] PROGMEM = {
+  {OV772x_REG_CLKRC, 0x00}, {OV772x_REG_BDBASE, 0xff}, {OV772x_REG_DBSTEP, 0x01},
+  {OV772x_REG_ADVFL, 0x00}, {OV772x_REG_ADVFH, 0x00},
+  {0xff, 0xff}	// END MARKER
+};
+
+const struct regval_list rate30_ov772x[] PROGMEM = {
+  {OV772x_REG_CLKRC, 0x01}, {OV772x_REG_BDBASE, 0x7f}, {OV772x_REG_DBSTEP, 0x03},
+  {OV772x_REG_ADVFL, 0x00}, {OV772x_REG_ADVFH, 0x00},
+  {0xff, 0xff}	// END MARKER
+};
+
+const struct regval_list rate15_ov772x[] PROGMEM = {
+  {OV772x_REG_CLKRC, 0x03}, {OV772x_REG_BDBASE, 0x3f}, {OV772x_REG_DBSTEP, 0x07},
+  {OV772x_REG_ADVFL, 0x00}, {OV772x_REG_ADVFH, 0x00},
+  {0xff, 0xff}	// END MARKER
+};
+
+// 15fps timing plus 510 dummy lines: ~7.5fps, twice the exposure range
+const struct regval_list rateLongExp_ov772x[] PROGMEM = {
+  {OV772x_REG_CLKRC, 0x03}, {OV772x_REG_BDBASE, 0x3f}, {OV772x_REG_DBSTEP, 0x07},
+  {OV772x_REG_ADVFL, 0xfe}, {OV772x_REG_ADVFH, 0x01},
+  {0xff, 0xff}	// END MARKER
+};
+
+// --------------------------------------------
+// output size only (DCW, zoom and output size), to switch formats at run
+// time without touching the rate, exposure or colour settings. Values as
+// in the format lists above.
+
+const struct regval_list qvga_scale_ov772x[] PROGMEM = {
+  {OV772x_REG_DSP_CTRL2, 0x2f}, // DCW enable, zoom out enable
+  {0xA0, 0x05}, // SCAL0, 1/2 vertical & horizontal down sampling
+  {0xA1, 0x40}, {0xA2, 0x40}, // SCAL1, SCAL2: zoom out ratio 1/1
+  {0x29, 0x50}, {0x2c, 0x78}, // Horizontal / Vertical Data Output Size (320x240) MSBs
+  {0xff, 0xff}	// END MARKER
+};
+
+const struct regval_list qqvga_scale_ov772x[] PROGMEM = {
+  {OV772x_REG_DSP_CTRL2, 0x2f},
+  {0xA0, 0x0a}, // SCAL0, 1/4 vertical & horizontal down sampling
+  {0xA1, 0x40}, {0xA2, 0x40},
+  {0x29, 0x28}, {0x2c, 0x3c}, // 160x120
+  {0xff, 0xff}	// END MARKER
+};
+
+const struct regval_list qqqvga_scale_ov772x[] PROGMEM = {
+  {OV772x_REG_DSP_CTRL2, 0x0f},
+  {0xA0, 0x0f}, // SCAL0, 1/8 vertical & horizontal down sampling
+  {0xA1, 0x80}, {0xA2, 0x80}, // zoom out ratio 1/2
+  {0x29, 0x14}, {0x2c, 0x22}, // 80x60
+  {0xff, 0xff}	// END MARKER
+};
   
 #endif /* _OV772x_REGS_H */
 
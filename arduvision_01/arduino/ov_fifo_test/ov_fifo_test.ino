@@ -42,22 +42,34 @@ __asm volatile ("nop");
 #include "IO_config.h"
 #include "sensor.h"
 #include "fifo.h"
+#include "ae.h"
+#include "stats.h"
+#include "cmd.h"
 #include <Wire.h>
 
 //#define USE_SOFT_SERIAL
+#define USE_LEAN_UART // built in USART0 driver (uart.h), instead of HardwareSerial
 // serial stuff  
 static const byte LF = 10; // line feed character
 #ifdef USE_SOFT_SERIAL
+   #undef USE_LEAN_UART // soft serial takes precedence
    #include <SoftwareSerial.h>
    static const unsigned int _BAUDRATE = 19200; // 19200 is the maximum reliable soft serial baud rate for 8MHz processors
    #define txPin A0
    #define rxPin A1
    SoftwareSerial mySerial = SoftwareSerial(rxPin, txPin);  
    SoftwareSerial *serialPtr = &mySerial;
+#elif defined(USE_LEAN_UART)
+   #include "uart.h"
+   // double speed mode: 500000, 1000000 and (16MHz only) 2000000 are exact,
+   // no need to patch the core's HardwareSerial.cpp
+   static const unsigned long _BAUDRATE = 1000000;
+   LeanUart *serialPtr = &leanUart;
 #else
    // 38400 is the maximum supposed reliable UART baud rate for 8MHz processors
    // However, I've had succes at 500000bps with an USB-FTDI cable
    // I've modified the file arduino-1.5.6-r2/hardware/arduino/avr/cores/arduino/HardwareSerial.cpp
+   // (arduino-1.6.5 for the Mega, SERIAL_RX_BUFFER_SIZE and rx_buffer_index_t there)
    // substituting all the lines with operations like this (for both rx and tx buffers):
    //
    //  _rx_buffer_tail = (uint8_t)(_rx_buffer_tail + 1) % SERIAL_BUFFER_SIZE;
@@ -72,15 +84,41 @@ static const byte LF = 10; // line feed character
    static const unsigned long _BAUDRATE = 500000;
    HardwareSerial *serialPtr = &Serial;
 #endif    
+#if defined(BOARD_HW_RCLK) && defined(USE_LEAN_UART)
+   // the engine polls the receiver itself and hands the bytes to leanUart
+   #define USE_HW_RCLK
+#endif
+
+#ifdef ENABLE_STATS
+stats_t stats;
+#endif
 
-uint8_t rcvbuf[16], rcvbufpos = 0, c;
+// Row output of the readout kernels. With the lean UART they write straight
+// to UDR0, overlapping the fifo readout with the transmission (accounted as
+// tx time in the stats); otherwise they fill rowBuf, sent afterwards.
+#ifdef USE_LEAN_UART
+  #define ROW_BEGIN     STATS_START(tRow); uart_sink rowOut
+  #define ROW_END(len)  leanUart.put(LF); STATS_ADD(txTicks, tRow); timebase_poll()
+#else
+  #define ROW_BEGIN     STATS_START(tRow); fifo_bufSink rowOut(rowBuf)
+  #define ROW_END(len)  STATS_ADD(readTicks, tRow); sendRow(rowBuf, len)
+#endif
 
-// fps calculation stuff
-static unsigned int oneSecond = 1000;
-unsigned int volatile frameCount = 0;
-unsigned int fps = 0;
-unsigned long volatile lastTime = 0;
-unsigned long volatile timeStamp = 0;
+// frame timing stuff: every VSYNC is timestamped in the interrupt handler
+// with Timer1, free running at clk/64 without interrupts (see timebase_stamp)
+static const uint8_t TICK_US = 64 / (F_CPU / 1000000UL);
+static const uint8_t FPS_WINDOW = 8; // VSYNCs in the sliding fps window
+uint16_t volatile timebaseHigh = 0;
+uint16_t volatile frameSeq = 0;       // sensor frames since power up
+uint16_t volatile droppedFrames = 0;  // VSYNCs missed while servicing a request
+uint32_t volatile framePeriod = 0;    // us, running average
+boolean  volatile bWasBusy = false;   // VSYNC interrupt was detached since the last one
+uint32_t volatile lastVsyncTime = 0;  // us
+uint32_t volatile captureTime = 0;    // us, start of the frame frozen in the fifo
+uint16_t volatile captureSeq = 0;     // sequence number of that frame
+uint32_t vsyncTimes[FPS_WINDOW];
+uint16_t vsyncSeqs[FPS_WINDOW];
+uint8_t  vsyncIdx = 0;
 
 //#define QQVGA
 #define QQQVGA
@@ -89,34 +127,132 @@ unsigned long volatile timeStamp = 0;
 static const uint8_t fW = 160;
 static const uint8_t fH = 120;
 static const frameFormat_t frameFormat = FF_QQVGA;
-#else ifdef QQQVGA
+#else
+#ifdef QQQVGA
 static const uint8_t fW = 80;
 static const uint8_t fH = 60;
 static const frameFormat_t frameFormat = FF_QQQVGA;
 #endif
+#endif
+
+// QVGA stills: captured on request and frozen in the fifo (150KB of its
+// 384KB), then read by the host in fW x fH tiles (see STILL CAPTURE)
+static const unsigned int STILL_W = 320;
+static const unsigned int STILL_H = 240;
+enum stillState_t {
+  STILL_NONE = 0,
+  STILL_ARMED, // sensor switched to QVGA, waiting for a whole frame
+  STILL_HELD   // fifo writes stopped on a QVGA frame
+};
+stillState_t volatile stillState = STILL_NONE;
+uint8_t volatile settleFrames = 0; // frames to discard after a format change
 
 static const uint8_t TRACK_BORDER = 4; // always multiple of 2 (YUYV: 2 pixels)
 static const uint8_t YUYV_BPP = 2; // bytes per pixel
 static const unsigned int MAX_FRAME_LEN = fW * YUYV_BPP;
 byte rowBuf[MAX_FRAME_LEN];
+byte colBuf[MAX_FRAME_LEN]; // per column state of the frame analysis modes
 unsigned int volatile nRowsSent = 0;
-boolean volatile bRequestPending = false;
 boolean volatile bNewFrame = false;
-uint8_t volatile thresh = 128;
+boolean volatile bAEPending = false;
+uint8_t thresh = 128; // for the CMD_SEND requests queued from now on
+
+// decimation of the requests queued from now on, set by CMD_DECIM:
+// factor (1, 2, 4 or 8) in the low bits, DECIM_BOX for 2x2 box averaging
+static const uint8_t DECIM_FACTOR = 0x0F;
+static const uint8_t DECIM_BOX    = 0x80;
+static const uint8_t DECIM_MAX    = 8;
+uint8_t decim = 1;
+
+// colour window of the SEND_COLOR requests served from now on, set by
+// CMD_COLOR_U/V/Y; reddish by default
+fifo_colorWin_t colorWin = { 0x50, 0x78, 0xA0, 0xF0, 0x10, 0xF0 };
+// colour signatures of the SEND_SIGS requests, set one by one by CMD_SIG
+// from colorWin (ranges rounded out to FIFO_SIG_SHIFT bins); none at first.
+// CMD_SIG edits a copy and then switches sigActive (a single byte store),
+// so the VSYNC handler never reads a half written table.
+fifo_sigLut_t sigLuts[2];
+uint8_t volatile sigActive = 0;
+
+// 3x3 morphology of the thresholded SEND_8PPB rows and SEND_DARK mask of
+// the requests queued from now on, set by CMD_MORPH
+enum morphMode_t {
+  MORPH_NONE = 0,
+  MORPH_ERODE,  // speckles off, blobs shrink a pixel
+  MORPH_DILATE, // holes filled, blobs grow a pixel
+  MORPH_OPEN    // erode then dilate: speckles off, blobs kept
+};
+uint8_t morphMode = MORPH_NONE;
+static const uint8_t MASK_LEN = fW / 8;
+struct morphStage_t {
+  uint8_t rows[4][MASK_LEN];      // 3 row window and the output row (see MORPHOLOGY)
+  uint8_t *above, *centre, *below;
+  uint8_t nIn, nOut;
+  boolean bErode;
+};
+morphStage_t morphStages[2];
+uint8_t morphRow[MASK_LEN];
+
+// modes read with the hardware RCLK engine (fifo_readRowHw), set by CMD_HWRCLK
+enum hwRclkMode_t {
+  HWRCLK_DARK = 0x02  // SEND_DARK tracking
+};
+uint8_t hwRclkModes = 0;
 
 enum serialRequest_t {
   SEND_NONE = 0,
   SEND_DARK,
   SEND_BRIG,
   SEND_FPS,
+  SEND_DECIM, // "Y" bytes of every Nth pixel and row, as set by CMD_DECIM
+  SEND_PROGRESSIVE, // "Y" rows in bit reversed order, coarse frame first
+  SEND_BITPLANES,   // 1 bit planes of Y, most significant first
+  SEND_ADAPTIVE,    // the richest row packing meeting targetFps (see ADAPTIVE ENCODING)
+  SEND_LASER,       // sub-pixel row of the brightest "Y" of every column (see LASER LINE)
+  SEND_SPOT,        // sub-pixel centroid of the brightest spot (see BRIGHTEST SPOT)
+  SEND_PROJECT = 11, // row and column sums of Y (see PROJECTIONS), clear of SEND_8PPB (10 or 20)
+  SEND_EGO,         // image shift since the last SEND_EGO request (see EGO-MOTION)
+  SEND_LINE,        // centre of the longest dark run of every row (see LINE FOLLOWING)
+  SEND_COLOR,       // blob of the pixels inside colorWin (see COLOUR TRACKING)
+  SEND_SIGS,        // box and area of every colour signature in sigLuts
+  SEND_EDGES,       // Sobel edge map, SEND_8PPB packing (see EDGES)
+  SEND_EDGES4,      // Sobel magnitude, 4 bits in the SEND_2PPB packing
+  SEND_HWCHECK,     // hardware RCLK engine against the software readout (see HARDWARE RCLK READOUT)
   SEND_0PPB = MAX_FRAME_LEN,
   SEND_1PPB = fW,
   SEND_2PPB = fW/2,
   SEND_4PPB = fW/4,
-  SEND_8PPB =fW/8 
+  SEND_8PPB =fW/8,
+  SEND_3BIT = fW*3/8, // 3 bit luminance, 8 pixels in 3 bytes
+  SEND_5BIT = fW*5/8  // 5 bit luminance (D7..D3, all the wired bits), 8 pixels in 5 bytes
+};
+
+// Adaptive encoding ladder, richest first: every step sends fewer bytes
+// per row and fewer luminance bits. SEND_1PPB is left out, its low 3 bits
+// are not wired: SEND_5BIT carries the same data in 5/8 of the bytes.
+// SEND_ADAPTIVE requests use the one picked for targetFps.
+static const serialRequest_t ADAPT_LADDER[] = {
+  SEND_0PPB, SEND_5BIT, SEND_2PPB, SEND_3BIT, SEND_4PPB, SEND_8PPB
 };
+static const uint8_t ADAPT_LEVELS = sizeof(ADAPT_LADDER) / sizeof(ADAPT_LADDER[0]);
+uint8_t targetFps = 0; // set by CMD_TARGET_FPS, 0: always the richest
+uint8_t adaptLevel = 0;
 
-serialRequest_t serialRequest = SEND_NONE;
+// Frame requests waiting for the VSYNC handler, so the host can keep
+// several in flight. Queued by processCommands() (main loop) and removed
+// by the VSYNC handler once the reply is sent, so an empty queue also
+// means no reply is being sent. Each reply header carries the host's tag.
+struct frameRequest_t {
+  serialRequest_t type;
+  uint8_t thresh;
+  uint8_t tag;
+  uint8_t decim; // SEND_DECIM rows, coarse to fine SEND_DARK if > 1
+  uint8_t morph; // morphMode_t of SEND_8PPB rows and SEND_DARK
+};
+static const uint8_t REQ_QUEUE_LEN = 4; // power of 2
+frameRequest_t reqQueue[REQ_QUEUE_LEN];
+uint8_t volatile reqHead = 0; // written by the main loop only
+uint8_t volatile reqTail = 0; // written by the VSYNC handler only
 
 
 // *****************************************************
@@ -127,6 +263,9 @@ void setup()
   setup_IO_ports();
   
   serialPtr->begin(_BAUDRATE);
+#ifdef USE_LEAN_UART
+  leanUart.onReceive(cmd_rxByte); // commands are parsed in the RX interrupt
+#endif
 
   serialPtr->println("Initializing sensor...");
   for (int i = 0; i < 10; i ++) {
@@ -144,7 +283,11 @@ void setup()
           delay(300);
       }
   }
- attachInterrupt(VSYNC_INT, &vsyncIntFunc, FALLING);
+  // Timer1 free running at clk/64 as frame timebase, no interrupts
+  TCCR1A = 0;
+  TCCR1B = _BV(CS11) | _BV(CS10);
+  TIMSK1 = 0;
+  attachInterrupt(VSYNC_INT, (void(*)())&vsyncIntFunc, FALLING);
   delay(100);
 }
 // *****************************************************
@@ -152,22 +295,43 @@ void setup()
 // *****************************************************
 void loop()
 {  
- 
-
+  timebase_poll();
+#ifdef USE_SOFT_SERIAL
+  serialEvent(); // the core only calls it for HardwareSerial
+#endif
+  processCommands();
+  // sensor registers are written out of the VSYNC handler, as I2C needs interrupts
+  if (bAEPending) {
+      bAEPending = false;
+      ae_apply();
+  }
 }
 
 // *****************************************************
 //               VSYNC INTERRUPT HANDLER
 // *****************************************************
 void __inline__ vsyncIntFunc() {
+      uint16_t tcnt = TCNT1; // capture first, constant latency from the edge
       DISABLE_WREN; // disable writing to fifo
+      stampVsync(timebase_stamp(tcnt));
           
-      if (bRequestPending && bNewFrame) {
+      if (stillState == STILL_HELD) {
+        // fifo frozen on a still, read by CMD_TILE from the main loop
+        STATS_ADD(isrTicks, tcnt);
+      }
+      else if (reqTail != reqHead && bNewFrame) {
         detachInterrupt(VSYNC_INT);
-        processRequest();
-        bRequestPending = false;
+        interrupts(); // keep receiving commands while the frame is sent
+        processRequest(reqQueue[reqTail]);
+        noInterrupts();
+        reqTail = (reqTail + 1) & (REQ_QUEUE_LEN - 1);
         bNewFrame = false;
-        attachInterrupt(VSYNC_INT, &vsyncIntFunc, FALLING);
+        bWasBusy = true;
+        attachInterrupt(VSYNC_INT, (void(*)())&vsyncIntFunc, FALLING);
+      }
+      else if (stillState == STILL_ARMED && bNewFrame) {
+        stillState = STILL_HELD; // keep the frame just written, writes stay off
+        STATS_ADD(isrTicks, tcnt);
       }
       else {
           ENABLE_WRST;
@@ -179,124 +343,1020 @@ void __inline__ vsyncIntFunc() {
           _delay_cycles(10);
          
           ENABLE_WREN; // enable writing to fifo
-          bNewFrame = true;
+          bNewFrame = (settleFrames == 0);
+          if (settleFrames) settleFrames--;
+          captureTime = lastVsyncTime;
+          captureSeq = frameSeq;
+          STATS_ADD(isrTicks, tcnt);
       }
 }
 
 // **************************************************************
 //                      PROCESS SERIAL REQUEST
 // **************************************************************
-void processRequest() {
+void processRequest(const frameRequest_t &req) {
   
+        serialRequest_t serialRequest = req.type;
+        uint8_t thresh = req.thresh;
+        uint32_t time0 = timebase_poll();
+
+        if (serialRequest == SEND_ADAPTIVE) serialRequest = ADAPT_LADDER[targetFps ? adaptLevel : 0];
         fifo_rrst();
+        if (serialRequest == SEND_HWCHECK) { // a text line, no frame reply
+#ifdef USE_HW_RCLK
+            hwRclk_check();
+#else
+            serialPtr->print("NAK\n");
+#endif
+            return;
+        }
+        ae_clearStats();
+        sendFrameHeader(req.tag, serialRequest == SEND_DECIM || serialRequest == SEND_DARK ?
+                                 req.decim & DECIM_FACTOR : 1, serialRequest);
         
         switch (serialRequest) {
           case SEND_0PPB: for (int i =0; i< fH; i++) {
-                              fifo_readRow0ppb(rowBuf, rowBuf+serialRequest);
-                              serialPtr->write(rowBuf, serialRequest);
-                              serialPtr->write(LF); 
+                              ROW_BEGIN;
+                              fifo_readRow0ppb(rowOut, serialRequest);
+                              ROW_END(serialRequest);
                           } break;
           case SEND_1PPB: for (int i =0; i< fH; i++) {
-                              fifo_readRow1ppb(rowBuf, rowBuf+serialRequest);
-                              serialPtr->write(rowBuf, serialRequest); 
-                              serialPtr->write(LF); 
+                              ROW_BEGIN;
+                              fifo_readRow1ppb(rowOut, serialRequest);
+                              ROW_END(serialRequest);
                           } break;
           case SEND_2PPB:  for (int i =0; i< fH; i++) {
-                              fifo_readRow2ppb(rowBuf, rowBuf+serialRequest);
-                              serialPtr->write(rowBuf, serialRequest); 
-                              serialPtr->write(LF); 
+                              ROW_BEGIN;
+                              fifo_readRowPacked<4, PACK_LUMA>(rowOut, serialRequest, thresh);
+                              ROW_END(serialRequest);
                           } break;
           case SEND_4PPB: for (int i =0; i< fH; i++) {
-                              fifo_readRow4ppb(rowBuf, rowBuf+serialRequest);
-                              serialPtr->write(rowBuf, serialRequest); 
-                              serialPtr->write(LF); 
+                              ROW_BEGIN;
+                              fifo_readRowPacked<2, PACK_LUMA>(rowOut, serialRequest, thresh);
+                              ROW_END(serialRequest);
                           } break;
-          case SEND_8PPB: for (int i =0; i< fH; i++) {
-                              fifo_readRow8ppb(rowBuf, rowBuf+serialRequest, thresh);
-                              serialPtr->write(rowBuf, serialRequest); 
-                              serialPtr->write(LF); 
+          case SEND_8PPB: if (req.morph != MORPH_NONE) {
+                              morph_frame(req.morph, thresh, 0);
+                              break;
+                          }
+                          for (int i =0; i< fH; i++) {
+                              ROW_BEGIN;
+                              fifo_readRowPacked<1, PACK_THRESH>(rowOut, serialRequest, thresh);
+                              ROW_END(serialRequest);
                           } break;
-          case SEND_BRIG: fifo_getBrig(rowBuf, fW, fH, TRACK_BORDER, thresh);
-                          serialPtr->write(rowBuf, 4);
-                          serialPtr->write(LF); 
+          case SEND_3BIT: for (int i =0; i< fH; i++) {
+                              ROW_BEGIN;
+                              fifo_readRowPacked<3, PACK_LUMA>(rowOut, serialRequest, thresh);
+                              ROW_END(serialRequest);
+                          } break;
+          case SEND_5BIT: for (int i =0; i< fH; i++) {
+                              ROW_BEGIN;
+                              fifo_readRowPacked<5, PACK_LUMA>(rowOut, serialRequest, thresh);
+                              ROW_END(serialRequest);
+                          } break;
+          case SEND_BRIG: {
+                          STATS_START(tRead);
+                          fifo_getBrig(rowBuf, fW, fH, TRACK_BORDER, thresh);
+                          STATS_ADD(readTicks, tRead);
+                          sendRow(rowBuf, 4);
+                        } break;
+          case SEND_DECIM: sendDecimated(req.decim);
+                          break;
+          case SEND_PROGRESSIVE: sendProgressive();
+                          break;
+          case SEND_BITPLANES: sendBitPlanes();
+                          break;
+          case SEND_LASER: sendLaserLine(thresh);
+                          break;
+          case SEND_SPOT: sendSpot();
                           break;
-          case SEND_DARK: fifo_getDark(rowBuf, fW, fH, TRACK_BORDER, thresh);
-                          serialPtr->write(rowBuf, 4);
-                          serialPtr->write(LF); 
+          case SEND_EDGES: sendEdges(false, thresh);
                           break;
-          case SEND_FPS:  calcFPS(fps);
-                          serialPtr->print(fps, DEC);
-                          serialPtr->write(LF); 
+          case SEND_EDGES4: sendEdges(true, thresh);
+                          break;
+          case SEND_PROJECT: sendProjections();
+                          break;
+          case SEND_EGO:  sendEgoMotion();
+                          break;
+          case SEND_LINE: sendLineCentres(thresh);
+                          break;
+          case SEND_COLOR: {
+                          STATS_START(tRead);
+                          fifo_getColor(rowBuf, fW, fH, colorWin);
+                          STATS_ADD(readTicks, tRead);
+                          sendRow(rowBuf, 8);
+                        } break;
+          case SEND_SIGS: {
+                          STATS_START(tRead);
+                          fifo_getSignatures(rowBuf, fW, fH, sigLuts[sigActive]);
+                          STATS_ADD(readTicks, tRead);
+                          sendRow(rowBuf, FIFO_SIG_MAX * 6);
+                        } break;
+          case SEND_DARK: {
+                          STATS_START(tRead);
+                          if (req.morph != MORPH_NONE) morph_frame(req.morph, thresh, rowBuf);
+                          else
+                          if ((req.decim & DECIM_FACTOR) > 1) getDarkCoarseFine(rowBuf, req.decim & DECIM_FACTOR, thresh);
+                          else
+#ifdef USE_HW_RCLK
+                          if (hwRclkModes & HWRCLK_DARK) getDarkHw(rowBuf, TRACK_BORDER, thresh);
+                          else
+#endif
+                          fifo_getDark(rowBuf, fW, fH, TRACK_BORDER, thresh);
+                          STATS_ADD(readTicks, tRead);
+                          sendRow(rowBuf, 4);
+                        } break;
+          case SEND_FPS:  printTenths(calcFPS());
                           break;
 
           default : break;
         }
+        if (ae_update()) bAEPending = true;
+        if (req.type == SEND_ADAPTIVE) adapt_update(timebase_poll() - time0);
+        STATS_INC(nRequests);
+}
+
+// **************************************************************
+//                    DECIMATED READOUT
+// **************************************************************
+// Every factor-th pixel of every factor-th row: fH / factor rows of
+// fW / factor "Y" bytes, the rest is skipped. With DECIM_BOX each output
+// pixel is the 2x2 box average of the top left corner of its cell, the
+// first row of the pair kept in rowBuf.
+void sendDecimated(uint8_t decimation) {
+        uint8_t factor = decimation & DECIM_FACTOR;
+        uint8_t nPix = fW / factor;
+        boolean bBox = (decimation & DECIM_BOX) && factor > 1;
+        unsigned int rowSkip = (unsigned int)(factor - (bBox ? 2 : 1)) * fW * YUYV_BPP;
+
+        for (uint8_t j = 0; j < fH; j += factor) {
+            if (bBox) {
+                STATS_START(tRead);
+                fifo_bufSink above(rowBuf);
+                fifo_readRowDecim<true, false>(above, rowBuf, nPix, factor);
+                STATS_ADD(readTicks, tRead);
+                ROW_BEGIN;
+                fifo_readRowDecim<true, true>(rowOut, rowBuf, nPix, factor);
+                ROW_END(nPix);
+            }
+            else {
+                ROW_BEGIN;
+                fifo_readRowDecim<false, false>(rowOut, rowBuf, nPix, factor);
+                ROW_END(nPix);
+            }
+            if (j + factor < fH) fifo_skipBytes(rowSkip);
+        }
 }
+// --------------------------------------------------------------
+// Dark blob tracking in two passes over the frame frozen in the fifo: a
+// search on every factor-th pixel and row, then a full resolution pass
+// on the found box grown by the sampling gap. Same output as
+// fifo_getDark(), written only if a box was found. The histogram is
+// kept from the first pass, which samples the whole frame evenly.
+void getDarkCoarseFine(uint8_t *out, uint8_t factor, uint8_t thresh) {
+        uint8_t box[4];
+        uint8_t lumOn = lumAccumOn;
+        uint8_t xMax = fW - TRACK_BORDER - 1; // as fifo_getDark()
+        uint8_t yMax = fH - TRACK_BORDER;
 
+        if (!fifo_findDark(box, fW, TRACK_BORDER, TRACK_BORDER, xMax, yMax, factor, thresh)) return;
+        uint8_t x0 = box[0] > TRACK_BORDER + factor - 1 ? box[0] - (factor - 1) : TRACK_BORDER;
+        uint8_t y0 = box[1] > TRACK_BORDER + factor - 1 ? box[1] - (factor - 1) : TRACK_BORDER;
+        uint8_t x1 = box[2] + factor < xMax ? box[2] + factor : xMax;
+        uint8_t y1 = box[3] + factor < yMax ? box[3] + factor : yMax;
 
+        lumAccumOn = 0;
+        fifo_rrst();
+        boolean bFound = fifo_findDark(box, fW, x0, y0, x1, y1, 1, thresh);
+        lumAccumOn = lumOn;
+        if (bFound && box[0] < box[2] && box[1] < box[3]) memcpy(out, box, sizeof(box));
+}
+// --------------------------------------------------------------
+// CMD_DECIM argument: factor in the low byte, rounded down to a power of
+// two up to DECIM_MAX, bit 8 for box averaging.
+uint8_t decimSetting(uint16_t arg) {
+        uint8_t factor = 1;
+        while (factor < DECIM_MAX && (factor << 1) <= (arg & 0xFF)) factor <<= 1;
+        if ((arg & 0x100) && factor > 1) return factor | DECIM_BOX;
+        return factor;
+}
 // **************************************************************
-//                      CALCULATE FPS
+//                   PROGRESSIVE READOUT
+// **************************************************************
+// The "Y" rows of the frame in bit reversed order (0, 32, 16, 48, 8, 24,
+// ...) so the host can show a coarse frame early and refine it: one pass
+// over the fifo per level, rewinding and seeking to the rows of the pass.
+// Each row starts with its index plus PROG_ROW_BASE, out of the way of
+// LF like the pixel data (sensor output range 0x10-0xF0).
+static const uint8_t PROG_ROW_BASE = 0x10;
+
+void sendProgressive(void) {
+        uint8_t top = 1; // stride of the first pass, half the power of 2 >= fH
+        while ((top << 1) < fH) top <<= 1;
+        uint8_t start = 0;
+        uint8_t stride = top;
+
+        while (1) {
+            fifo_rrst();
+            fifo_skipBytes((unsigned int)start * MAX_FRAME_LEN);
+            for (uint8_t j = start; j < fH; j += stride) {
+                ROW_BEGIN;
+                rowOut.put(j + PROG_ROW_BASE);
+                fifo_readRowDecim<false, false>(rowOut, rowBuf, fW, 1);
+                ROW_END(fW + 1);
+                if (j + stride < fH) fifo_skipBytes((unsigned int)(stride - 1) * MAX_FRAME_LEN);
+            }
+            if (start == 1 || top == 1) break;
+            start = start ? start >> 1 : top >> 1; // the rows half way between those sent
+            stride = start << 1;
+        }
+}
+// **************************************************************
+//                   BIT PLANE READOUT
+// **************************************************************
+// The luminance bit planes, most significant first, each a fresh pass
+// over the frozen fifo: fH rows of fW / 8 bytes (the SEND_8PPB packing
+// with a plane mask instead of the threshold), every row prefixed by
+// the plane ('7' to '3') and its index plus PROG_ROW_BASE. The planes
+// stop after the one during which a new command arrived, so the host
+// picks the depth by when it asks for something else. "E" ends the reply.
+// Planes under PLANE_LOWEST are not sent: D2..D0 are not wired to the
+// sensor (VSYNC and the UART pins on the 328p, unconnected on the Mega).
+static const uint8_t PLANE_LOWEST = 3;
+
+void sendBitPlanes(void) {
+        cmd_t next;
+
+        for (uint8_t plane = 8; plane-- > PLANE_LOWEST; ) {
+            fifo_rrst();
+            for (uint8_t j = 0; j < fH; j++) {
+                ROW_BEGIN;
+                rowOut.put('0' + plane);
+                rowOut.put(j + PROG_ROW_BASE);
+                fifo_readRowPacked<1, PACK_PLANE>(rowOut, SEND_8PPB, 1 << plane);
+                ROW_END(SEND_8PPB + 2);
+            }
+            lumAccumOn = 0; // the histogram holds the first pass only
+            if (cmd_peek(next)) break;
+        }
+        serialPtr->print("E\n");
+}
+// **************************************************************
+//                   ADAPTIVE ENCODING
 // **************************************************************
-void calcFPS(unsigned int &currentFPS) {
-      unsigned long currTime = millis();
-      unsigned long currTimeDiff = currTime-lastTime;
-      if (currTimeDiff >= oneSecond) {
-        lastTime = currTime;
-        currentFPS = (oneSecond*frameCount)/currTimeDiff;
-       frameCount = 0;
-       
+// Steps along ADAPT_LADDER after each SEND_ADAPTIVE reply so the replies
+// hold targetFps. A reply must fit the target period minus the frame
+// needed to capture the next one (the fifo is re-armed only once it is
+// sent). The service time is mostly transmit time, so the next richer
+// packing is predicted in proportion to its row length, and only taken
+// with 1/8 of the budget to spare, so it doesn't flip back and forth.
+void adapt_update(uint32_t serviceUs) {
+      if (targetFps == 0) return;
+      uint32_t period = 1000000UL / targetFps;
+      uint32_t budget = period > framePeriod ? period - framePeriod : 0;
+
+      if (serviceUs > budget) {
+          if (adaptLevel < ADAPT_LEVELS - 1) adaptLevel++;
+      }
+      else if (adaptLevel > 0) {
+          uint32_t richerUs = serviceUs * ADAPT_LADDER[adaptLevel - 1] / ADAPT_LADDER[adaptLevel];
+          if (richerUs < budget - (budget >> 3)) adaptLevel--;
       }
-      while (GET_VSYNC); // wait for an old frame to end
-      while (!GET_VSYNC);// wait for a new frame to start
-      frameCount++;
 }
 // **************************************************************
-//                      SERIAL EVENT
+//                        LASER LINE
+// **************************************************************
+// Line laser profile: fW little endian words, the row of the brightest
+// "Y" of each column (at least minPeak, 0xFFFF for none) times 256 plus
+// the sub-pixel offset, 2 * fW bytes against a whole frame.
+void sendLaserLine(uint8_t minPeak) {
+        STATS_START(tRead);
+        fifo_getLaserLine((uint16_t *)rowBuf, colBuf, colBuf + fW, fW, fH, minPeak);
+        STATS_ADD(readTicks, tRead);
+        sendRow(rowBuf, fW * sizeof(uint16_t));
+}
+// **************************************************************
+//                      BRIGHTEST SPOT
+// **************************************************************
+// LED or laser pointer marker: the brightest "Y" of the frame, then on a
+// second pass the centroid of the pixels over half of it around it, so
+// no threshold has to follow the exposure. Replies x and y times 256
+// (little endian words) and the peak value.
+static const uint8_t SPOT_RADIUS = 4; // centroid window of 9x9 pixels
+
+void sendSpot(void) {
+        uint8_t at[2];
+
+        STATS_START(tRead);
+        uint8_t peak = fifo_findPeak(at, fW, fH);
+        fifo_rrst();
+        fifo_spotCentroid((uint16_t *)rowBuf, fW, fH, at[0], at[1], SPOT_RADIUS, peak >> 1);
+        STATS_ADD(readTicks, tRead);
+        rowBuf[4] = peak;
+        sendRow(rowBuf, 5);
+}
+// **************************************************************
+//                       PROJECTIONS
+// **************************************************************
+// The sums of "Y" of every row and of every column, enough for line
+// following, gap finding or ego-motion: two rows of little endian
+// words, fH row sums then fW column sums (280 bytes at QQQVGA).
+void sendProjections(void) {
+        STATS_START(tRead);
+        fifo_getProjections((uint16_t *)rowBuf, (uint16_t *)colBuf, fW, fH);
+        STATS_ADD(readTicks, tRead);
+        sendRow(rowBuf, fH * sizeof(uint16_t));
+        sendRow(colBuf, fW * sizeof(uint16_t));
+}
+// **************************************************************
+//                        EGO-MOTION
+// **************************************************************
+// Optical odometry from the projection profiles, kept as the mean "Y" of
+// every row and column of the frame of the previous SEND_EGO request.
+// Replies the shift of the image since then in x and y (signed, 1/8
+// pixel) and the confidence of each (0 featureless to 255), 4 bytes.
+static const int8_t EGO_RANGE = 8; // pixels searched each way
+uint8_t egoRows[fH];
+uint8_t egoCols[fW];
+boolean bEgoValid = false;
+
+void sendEgoMotion(void) {
+        uint8_t reply[4] = { 0, 0, 0, 0 };
+
+        STATS_START(tRead);
+        fifo_getProjections((uint16_t *)rowBuf, (uint16_t *)colBuf, fW, fH);
+        STATS_ADD(readTicks, tRead);
+        ego_means(rowBuf, fH, fW);
+        ego_means(colBuf, fW, fH);
+        if (bEgoValid) {
+            reply[0] = ego_matchProfile(colBuf, egoCols, fW, reply[2]);
+            reply[1] = ego_matchProfile(rowBuf, egoRows, fH, reply[3]);
+        }
+        memcpy(egoRows, rowBuf, fH);
+        memcpy(egoCols, colBuf, fW);
+        bEgoValid = true;
+        sendRow(reply, sizeof(reply));
+}
+// --------------------------------------------------------------
+// n 16 bit sums of count "Y" each to their 8 bit means, in place
+void ego_means(uint8_t *buf, uint8_t n, uint8_t count) {
+        uint16_t *sum = (uint16_t *)buf;
+
+        for (uint8_t i = 0; i < n; i++) buf[i] = sum[i] / count; // byte i is behind sum[i]
+}
+// --------------------------------------------------------------
+// Shift s within +-EGO_RANGE best matching cur[i] to prev[i - s], by the
+// mean absolute difference over the overlap once the mean of each
+// profile is removed (an exposure change moves a profile as a whole),
+// refined to 1/8 pixel by a parabola through the neighbouring costs.
+// conf tells how far the best cost is below the average of all shifts.
+int8_t ego_matchProfile(const uint8_t *cur, const uint8_t *prev, uint8_t n, uint8_t &conf) {
+        uint16_t cost[2 * EGO_RANGE + 1];
+        uint16_t sumCur = 0, sumPrev = 0;
+        uint32_t total = 0;
+        uint8_t best = EGO_RANGE; // no shift unless another one is better
+
+        for (uint8_t i = 0; i < n; i++) {
+            sumCur += cur[i];
+            sumPrev += prev[i];
+        }
+        int16_t bias = (int16_t)(sumCur / n) - (int16_t)(sumPrev / n);
+        for (uint8_t k = 0; k <= 2 * EGO_RANGE; k++) {
+            int8_t shift = k - EGO_RANGE;
+            uint8_t i0 = shift > 0 ? shift : 0;
+            uint8_t i1 = shift < 0 ? n + shift : n;
+            uint32_t sad = 0;
+            for (uint8_t i = i0; i < i1; i++) {
+                int16_t d = (int16_t)cur[i] - prev[i - shift] - bias;
+                sad += d < 0 ? -d : d;
+            }
+            cost[k] = (sad << 4) / (i1 - i0);
+            total += cost[k];
+        }
+        for (uint8_t k = 0; k <= 2 * EGO_RANGE; k++)
+            if (cost[k] < cost[best]) best = k;
+        uint16_t average = total / (2 * EGO_RANGE + 1);
+        conf = average ? (uint32_t)(average - cost[best]) * 255 / average : 0;
+
+        int8_t offset = 0;
+        if (best > 0 && best < 2 * EGO_RANGE) {
+            int16_t curv = (int16_t)cost[best - 1] + cost[best + 1] - 2 * cost[best];
+            if (curv > 0) offset = ((int16_t)cost[best - 1] - cost[best + 1]) * 4 / curv;
+            if (offset > 4) offset = 4;
+            else if (offset < -4) offset = -4;
+        }
+        return (best - EGO_RANGE) * 8 + offset;
+}
+// **************************************************************
+//                      LINE FOLLOWING
+// **************************************************************
+// Guide line position: fH bytes, for every row the centre column of its
+// longest run darker than thresh, 0xFF for rows without a line (no run
+// of LINE_MIN_RUN pixels), so speckles are not taken for it.
+static const uint8_t LINE_MIN_RUN = 2;
+
+void sendLineCentres(uint8_t thresh) {
+        STATS_START(tRead);
+        fifo_getLineCentres(rowBuf, fW, fH, thresh, LINE_MIN_RUN);
+        STATS_ADD(readTicks, tRead);
+        sendRow(rowBuf, fH);
+}
 // **************************************************************
+//                     COLOUR TRACKING
+// **************************************************************
+// CMD_COLOR_U/V/Y: a range of colorWin, min in the low byte of the
+// argument, max in the high one.
+void colorRange(uint8_t &rangeMin, uint8_t &rangeMax, uint16_t arg) {
+      noInterrupts(); // not half changed for a request being served
+      rangeMin = arg & 0xFF;
+      rangeMax = arg >> 8;
+      interrupts();
+}
+// **************************************************************
+//                       MORPHOLOGY
+// **************************************************************
+// 3x3 erosion and dilation of 1 bit masks packed as SEND_8PPB (pixel x in
+// bit x & 7 of byte x >> 3), as the rows are read: a stage keeps a 3 row
+// window, each row already combined with its left and right neighbours
+// a byte at a time, and outputs the centre row combined with the rows
+// above and below once the row below is in. Pixels out of the frame
+// don't count (taken as 1 eroding, 0 dilating). Opening chains two
+// stages, so its rows come out 2 rows behind the fifo.
+void morph_begin(morphStage_t &st, boolean bErode) {
+      st.above = st.rows[0];
+      st.centre = st.rows[1];
+      st.below = st.rows[2];
+      memset(st.rows, bErode ? 0xFF : 0, 3 * MASK_LEN);
+      st.nIn = st.nOut = 0;
+      st.bErode = bErode;
+}
+// --------------------------------------------------------------
+// Row in combined with its left and right neighbours
+void morph_across(uint8_t *out, const uint8_t *in, boolean bErode) {
+      uint8_t edge = bErode ? 0xFF : 0;
+      uint8_t carry = edge & 1; // pixel left of the row
+
+      for (uint8_t k = 0; k < MASK_LEN; k++) {
+          uint8_t c = in[k];
+          uint8_t next = k + 1 < MASK_LEN ? in[k + 1] : edge;
+          uint8_t left = (c << 1) | carry;
+          uint8_t right = (c >> 1) | (next << 7);
+          out[k] = bErode ? c & left & right : c | left | right;
+          carry = c >> 7;
+      }
+}
+// --------------------------------------------------------------
+// Feeds the next row to a stage, NULL past the last one. Returns the next
+// output row, NULL while the first row waits for the one below it and
+// once all fH are out.
+const uint8_t *morph_push(morphStage_t &st, const uint8_t *in) {
+      if (st.nOut == fH) return 0;
+      uint8_t *row = st.above; // oldest row, reused for the new one
+      st.above = st.centre;
+      st.centre = st.below;
+      st.below = row;
+      if (in) morph_across(row, in, st.bErode);
+      else memset(row, st.bErode ? 0xFF : 0, MASK_LEN);
+      if (st.nIn++ == 0) return 0;
+
+      uint8_t *out = st.rows[3];
+      for (uint8_t k = 0; k < MASK_LEN; k++)
+          out[k] = st.bErode ? st.above[k] & st.centre[k] & st.below[k]
+                             : st.above[k] | st.centre[k] | st.below[k];
+      st.nOut++;
+      return out;
+}
+// --------------------------------------------------------------
+// Reads the mask of the frame through the stages of mode: with box NULL
+// the pixels over thresh, sent as SEND_8PPB rows, otherwise those under
+// it (to the 8 levels of the SEND_8PPB threshold), whose box within
+// TRACK_BORDER goes to box[] as SEND_DARK, all 0 if none.
+void morph_frame(uint8_t mode, uint8_t thresh, uint8_t *box) {
+      uint8_t nStages = (mode == MORPH_OPEN) ? 2 : 1;
+      uint8_t j = 0;
+
+      if (box) box[1] = 255; // none yet
+      morph_begin(morphStages[0], mode != MORPH_DILATE);
+      morph_begin(morphStages[1], false);
+      for (uint8_t i = 0; j < fH; i++) {
+          const uint8_t *row = 0;
+          if (i < fH) {
+              fifo_bufSink mask(morphRow);
+              fifo_readRowPacked<1, PACK_THRESH>(mask, MASK_LEN, thresh);
+              if (box)
+                  for (uint8_t k = 0; k < MASK_LEN; k++) morphRow[k] = ~morphRow[k];
+              row = morphRow;
+          }
+          for (uint8_t s = 0; s < nStages; s++) {
+              boolean bDone = morphStages[s].nOut == fH;
+              row = morph_push(morphStages[s], row);
+              if (!row && !bDone) break; // stage still filling
+          }
+          if (!row) continue;
+          if (box) morph_boxRow(box, row, j);
+          else sendRow((uint8_t *)row, MASK_LEN);
+          j++;
+      }
+      if (box && box[1] == 255) memset(box, 0, 4);
+}
+// --------------------------------------------------------------
+// Grows box[] by the pixels of row j within TRACK_BORDER (under 8)
+void morph_boxRow(uint8_t *box, const uint8_t *row, uint8_t j) {
+      if (j < TRACK_BORDER || j >= fH - TRACK_BORDER) return;
+      for (uint8_t k = 0; k < MASK_LEN; k++) {
+          uint8_t bits = row[k];
+          if (k == 0) bits &= 0xFF << TRACK_BORDER;
+          if (k == MASK_LEN - 1) bits &= 0xFF >> TRACK_BORDER;
+          if (bits == 0) continue;
+          uint8_t x0 = k * 8 + fifo_firstPix(bits), x1 = k * 8 + fifo_lastPix(bits);
+          if (box[1] == 255) { // first one
+              box[0] = x0;
+              box[1] = j;
+              box[2] = x1;
+          }
+          if (x0 < box[0]) box[0] = x0;
+          if (x1 > box[2]) box[2] = x1;
+          box[3] = j;
+      }
+}
+// the ends of a run starting and ending mid-byte (pixels 4..13: 0xF0 0x3F),
+// and of single pixels
+static_assert(fifo_firstPix(0xF0) == 4 && fifo_lastPix(0xF0) == 7 &&
+              fifo_firstPix(0x3F) == 0 && fifo_lastPix(0x3F) == 5, "morph_boxRow run ends");
+static_assert(fifo_firstPix(0x80) == 7 && fifo_lastPix(0x01) == 0 &&
+              fifo_firstPix(0x18) == 3 && fifo_lastPix(0x18) == 4, "morph_boxRow run ends");
+// **************************************************************
+//                          EDGES
+// **************************************************************
+// Sobel gradient magnitude |Gx| + |Gy| (0 to 2040) of the rows as they
+// come: the "Y" of the last three rows are kept in colBuf and rowBuf, and
+// every row is sent once the one below it is in. SEND_EDGES sets the
+// pixels with a magnitude of 4 * thresh or more (a step of thresh levels)
+// in the SEND_8PPB packing; SEND_EDGES4 sends the magnitude / 64, up to
+// 15, in the SEND_2PPB one. The frame border is 0.
+void sendEdges(boolean bMag, uint8_t thresh) {
+        uint8_t *rows[3] = { colBuf, colBuf + fW, rowBuf };
+        uint8_t *out = rowBuf + fW;
+        unsigned int len = bMag ? SEND_2PPB : SEND_8PPB;
+        uint16_t minMag = (uint16_t)thresh << 2;
+
+        for (uint8_t j = 0; j < fH; j++) {
+            uint8_t *row = rows[j % 3];
+            STATS_START(tRead);
+            fifo_bufSink in(row);
+            fifo_readRowDecim<false, false>(in, row, fW, 1);
+            STATS_ADD(readTicks, tRead);
+            if (j == 1) continue; // row 0 is sent without the one above it
+            if (j == 0) memset(out, 0, len);
+            else edge_row(out, rows[(j + 1) % 3], rows[(j + 2) % 3], row, bMag, minMag);
+            sendRow(out, len);
+        }
+        memset(out, 0, len);
+        sendRow(out, len);
+}
+// --------------------------------------------------------------
+// Packed edges of row b, between rows a (above) and c. The 3x3 kernels
+// are split in a vertical pass kept in a sliding window: Gx is the
+// difference of the smoothed columns x+1 and x-1, Gy the smoothed
+// difference of rows c and a.
+void edge_row(uint8_t *out, const uint8_t *a, const uint8_t *b, const uint8_t *c, boolean bMag, uint16_t minMag) {
+        int16_t sL = a[0] + 2 * b[0] + c[0], sC = a[1] + 2 * b[1] + c[1];
+        int16_t dL = (int16_t)c[0] - a[0], dC = (int16_t)c[1] - a[1];
+
+        memset(out, 0, bMag ? SEND_2PPB : SEND_8PPB);
+        for (uint8_t x = 1; x < fW - 1; x++) {
+            int16_t sR = a[x + 1] + 2 * b[x + 1] + c[x + 1];
+            int16_t dR = (int16_t)c[x + 1] - a[x + 1];
+            int16_t gx = sR - sL;
+            int16_t gy = dL + 2 * dC + dR;
+            uint16_t mag = (gx < 0 ? -gx : gx) + (gy < 0 ? -gy : gy);
+            if (bMag) {
+                uint8_t m = mag >> 6;
+                if (m > 15) m = 15;
+                out[x >> 1] |= (x & 1) ? m << 4 : m;
+            }
+            else if (mag >= minMag) out[x >> 3] |= 1 << (x & 7);
+            sL = sC; sC = sR;
+            dL = dC; dC = dR;
+        }
+}
+// **************************************************************
+//                      STILL CAPTURE
+// **************************************************************
+// The sensor is switched to QVGA until a whole frame is written to the
+// fifo, where it is kept (writes off, the VSYNC handler leaves the fifo
+// alone) and read in tiles by sendTile() until still_release(), called
+// for CMD_STILL 0 and by the next frame request. Replies the frame header
+// once held, "NAK" if VSYNC stopped or the sensor can't switch.
+void still_capture(uint8_t tag) {
+      static const unsigned long TIMEOUT_MS = 2000;
+      unsigned long time0 = millis();
+
+      still_release();
+      if (!sensor_setFormat(FF_QVGA)) {
+          serialPtr->print("NAK\n");
+          return;
+      }
+      noInterrupts();
+      bNewFrame = false; // the frame being written is corrupt
+      settleFrames = 1;
+      stillState = STILL_ARMED;
+      interrupts();
+      while (stillState != STILL_HELD) {
+          timebase_poll();
+          if (millis() - time0 > TIMEOUT_MS) {
+              still_release();
+              serialPtr->print("NAK\n");
+              return;
+          }
+      }
+      sendFrameHeader(tag, 1, SEND_NONE);
+}
+// --------------------------------------------------------------
+void still_release(void) {
+      if (stillState == STILL_NONE) return;
+      sensor_setFormat(frameFormat);
+      noInterrupts();
+      stillState = STILL_NONE;
+      bNewFrame = false;
+      settleFrames = 1;
+      interrupts();
+}
+// --------------------------------------------------------------
+// Tile (tx, ty) of the held still: the frame header and fH rows of fW
+// YUYV pixels (as SEND_0PPB), seeking to each row from the read pointer
+// reset. "NAK" if there is no still or the tile is out of it.
+void sendTile(uint8_t tag, uint8_t tx, uint8_t ty) {
+      if (stillState != STILL_HELD || tx >= STILL_W / fW || ty >= STILL_H / fH) {
+          serialPtr->print("NAK\n");
+          return;
+      }
+      fifo_rrst();
+      fifo_skipBytes(((unsigned long)ty * fH * STILL_W + (unsigned int)tx * fW) * YUYV_BPP);
+      sendFrameHeader(tag, 1, SEND_0PPB);
+      for (uint8_t j = 0; j < fH; j++) {
+          ROW_BEGIN;
+          fifo_readRow0ppb(rowOut, MAX_FRAME_LEN);
+          ROW_END(MAX_FRAME_LEN);
+          if (j + 1 < fH) fifo_skipBytes((STILL_W - fW) * YUYV_BPP);
+      }
+}
+// **************************************************************
+//                      SEND ROW
+// **************************************************************
+void sendRow(uint8_t *buf, unsigned int len) {
+        STATS_START(tSend);
+#if defined(ENABLE_STATS) && !defined(USE_SOFT_SERIAL) && !defined(USE_LEAN_UART)
+        if (serialPtr->availableForWrite() <= (int)len) STATS_INC(txStalls);
+#endif
+        serialPtr->write(buf, len);
+        serialPtr->write(LF);
+        STATS_ADD(txTicks, tSend);
+        timebase_poll();
+}
+
+
+// **************************************************************
+//                      FRAME TIMEBASE
+// **************************************************************
+// Returns the timestamp in us of a Timer1 count read with interrupts off.
+// Timer1 runs without interrupts so the readout loops are never disturbed
+// (and its ICP1 pin is taken by FIFO_WEN on the 328p, not broken out on
+// the Mega): its overflow flag is polled here instead, on every VSYNC,
+// row sent and loop() pass, far more often than the wrap period (~0.5s
+// at 8MHz, ~0.26s at 16MHz).
+uint32_t timebase_stamp(uint16_t tcnt) {
+      uint16_t high = timebaseHigh;
+      if (TIFR1 & _BV(TOV1)) {
+          TIFR1 = _BV(TOV1); // cleared by writing a one
+          timebaseHigh = ++high;
+          if (tcnt >= 0x8000) high--; // wrapped after tcnt was read
+      }
+      return ((((uint32_t)high) << 16) | tcnt) * TICK_US;
+}
+// --------------------------------------------------------------
+// Keeps track of the overflows, returns the current time in us.
+uint32_t timebase_poll() {
+      uint8_t oldSREG = SREG;
+      noInterrupts();
+      uint32_t now = timebase_stamp(TCNT1);
+      SREG = oldSREG;
+      return now;
+}
+#ifdef USE_HW_RCLK
+// **************************************************************
+//                 HARDWARE RCLK READOUT
+// **************************************************************
+// Runs fifo_readRowHw(), which borrows Timer1, with interrupts off for
+// the whole row (they would break its cycle lock) and moves the timebase
+// forward by the time it was taken. The engine polls the UART receiver:
+// the bytes it got are handed to leanUart as the RX interrupt would, before
+// interrupts are back on, so commands are neither lost nor reordered.
+static const unsigned long UART_BYTE_CYCLES = F_CPU * 10 / _BAUDRATE;
+static_assert(UART_BYTE_CYCLES > HW_RCLK_PASS, "UART too fast for one poll per engine pass");
+// received during a row, plus the two the USART may hold when it starts
+static const uint8_t HW_RCLK_RX_MAX = (unsigned long)MAX_FRAME_LEN * HW_RCLK_PERIOD / UART_BYTE_CYCLES + 3;
+
+void hwRclk_readRow(uint8_t *buf, unsigned int nBytes) {
+      static uint8_t cycleRem = 0; // carried fraction of a tick
+      uint8_t rx[HW_RCLK_RX_MAX + 1]; // + the engine's spare byte
+      uint8_t nRx;
+      uint8_t oldSREG = SREG;
+      noInterrupts();
+      uint16_t tcnt = TCNT1;
+      timebase_stamp(tcnt); // take any pending overflow first
+      uint16_t cycles = fifo_readRowHw(buf, nBytes, rx, nRx);
+      cycles += cycleRem;
+      cycleRem = cycles % STATS_CYCLES_PER_TICK;
+      uint16_t ticks = cycles / STATS_CYCLES_PER_TICK;
+      if ((uint16_t)(tcnt + ticks) < tcnt) timebaseHigh++; // wrapped while borrowed
+      TCNT1 = tcnt + ticks;
+      TCCR1B = _BV(CS11) | _BV(CS10);
+      for (uint8_t k = 0; k < nRx; k++) leanUart.received(rx[k]);
+      SREG = oldSREG;
+}
+// --------------------------------------------------------------
+// SEND_HWCHECK: the "Y" bytes of the first row of the frame read twice,
+// by fifo_readRowDecim() as fifo_getDark() reads them and by the engine.
+// Replies "HWRCLK <software> <engine> <bytes that differ>", times in
+// Timer1 ticks (STATS_CYCLES_PER_TICK cycles) for the whole row.
+void hwRclk_check(void) {
+      uint16_t ticks[2];
+      unsigned int nDiff = 0;
 
+      fifo_bufSink sw(rowBuf);
+      uint16_t t0 = TCNT1;
+      fifo_readRowDecim<false, false>(sw, rowBuf, fW, 1);
+      ticks[0] = TCNT1 - t0;
+      fifo_rrst();
+      t0 = TCNT1;
+      hwRclk_readRow(colBuf, fW * YUYV_BPP);
+      ticks[1] = TCNT1 - t0;
+      for (uint8_t k = 0; k < fW; k++)
+          if (colBuf[k] != rowBuf[k]) nDiff++;
+
+      serialPtr->print("HWRCLK");
+      for (uint8_t k = 0; k < 2; k++) {
+          serialPtr->write(' ');
+          serialPtr->print(ticks[k]);
+      }
+      serialPtr->write(' ');
+      serialPtr->print(nDiff);
+      serialPtr->write(LF);
+}
+// --------------------------------------------------------------
+// fifo_getDark() on whole rows of "Y" bytes read by the engine, then
+// scanned from RAM. Same output: bounding box of the pixels under thresh.
+void getDarkHw(uint8_t *out, uint8_t border, uint8_t thresh) {
+      LUM_GATE;
+      uint8_t x0 = 255, y0 = 255, x1 = 0, y1 = 0;
+
+      fifo_skipBytes((unsigned int)border * fW * YUYV_BPP);
+      for (uint8_t j = border; j < fH - border; j++) {
+          hwRclk_readRow(rowBuf, fW * YUYV_BPP);
+          for (uint8_t i = border; i < fW - border - 1; i++) {
+              LUM_ACCUM(rowBuf[i]); // the pixels fifo_getDark() takes
+              if (rowBuf[i] < thresh) {
+                  if (i > x1) x1 = i;
+                  else if (i < x0) x0 = i;
+                  if (y0 == 255) y0 = j; // first time only
+                  y1 = j;
+              }
+          }
+      }
+      if ((x0 < x1) && (y0 < y1)) {
+          out[0] = x0;
+          out[1] = y0;
+          out[2] = x1;
+          out[3] = y1;
+      }
+}
+#endif
+// **************************************************************
+//                   VSYNC BOOKKEEPING
+// **************************************************************
+// Called from the VSYNC handler. VSYNC edges arriving while a request was
+// being serviced are not seen (the interrupt is detached), so they are
+// recovered from the gap to the previous one.
+void stampVsync(uint32_t now) {
+      uint32_t dt = now - lastVsyncTime;
+      uint16_t nFrames = 1;
+
+      if (bWasBusy) {
+          if (framePeriod != 0 && dt > framePeriod + (framePeriod >> 1)) {
+              nFrames = (dt + (framePeriod >> 1)) / framePeriod;
+              droppedFrames += nFrames - 1;
+              STATS_INC_BY(vsyncBusy, nFrames - 1);
+          }
+          bWasBusy = false;
+      }
+      else if (frameSeq != 0) {
+          if (framePeriod == 0) framePeriod = dt;
+          else framePeriod = (framePeriod * 7 + dt) >> 3;
+      }
+
+      lastVsyncTime = now;
+      frameSeq += nFrames;
+      vsyncIdx = (vsyncIdx + 1) % FPS_WINDOW;
+      vsyncTimes[vsyncIdx] = now;
+      vsyncSeqs[vsyncIdx] = frameSeq;
+}
+// **************************************************************
+//                      CALCULATE FPS
+// **************************************************************
+// Sliding window frame rate in tenths of fps, no waiting involved.
+unsigned int calcFPS() {
+      uint32_t dt;
+      uint16_t nFrames;
+      uint8_t oldSREG = SREG;
+      noInterrupts();
+      uint8_t oldest = (vsyncIdx + 1) % FPS_WINDOW;
+      dt = vsyncTimes[vsyncIdx] - vsyncTimes[oldest];
+      nFrames = vsyncSeqs[vsyncIdx] - vsyncSeqs[oldest];
+      SREG = oldSREG;
+      if (dt == 0) return 0;
+      return (10UL * 1000000UL * nFrames) / dt;
+}
+// --------------------------------------------------------------
+void printTenths(unsigned int value) {
+      serialPtr->print(value / 10, DEC);
+      serialPtr->print(".");
+      serialPtr->print(value % 10, DEC);
+      serialPtr->write(LF);
+}
+// **************************************************************
+//                      FRAME HEADER
+// **************************************************************
+// Text line sent ahead of every reply:
+// "T <seq> <capture us> <dropped> <request tag> <decimation> <encoding>".
+// The capture time is the VSYNC that started writing the frame to the
+// fifo, in the MCU timebase, so the host can match it to its own clock.
+// The decimation factor is the one the reply was read with (1: full size)
+// and the encoding the serialRequest_t sent, SEND_ADAPTIVE resolved.
+void sendFrameHeader(uint8_t tag, uint8_t factor, unsigned int encoding) {
+      serialPtr->print("T ");
+      serialPtr->print(captureSeq, DEC);
+      serialPtr->print(" ");
+      serialPtr->print(captureTime, DEC);
+      serialPtr->print(" ");
+      serialPtr->print(droppedFrames, DEC);
+      serialPtr->print(" ");
+      serialPtr->print(tag, DEC);
+      serialPtr->print(" ");
+      serialPtr->print(factor, DEC);
+      serialPtr->print(" ");
+      serialPtr->print(encoding, DEC);
+      serialPtr->write(LF);
+}
+// **************************************************************
+//                        SEND STATS
+// **************************************************************
+// Replies 'S', the raw stats_t record and LF, then clears the counters so
+// each dump covers the time since the previous one. "NAK" if compiled out.
+void sendStats() {
+#ifdef ENABLE_STATS
+      stats_t snapshot;
+      noInterrupts();
+      snapshot = stats;
+      memset(&stats, 0, sizeof(stats));
+      interrupts();
+#ifdef USE_LEAN_UART
+      snapshot.rxOverflows += leanUart.rxDropped(true);
+#endif
+      serialPtr->write('S');
+      serialPtr->write((uint8_t *)&snapshot, sizeof(snapshot));
+      serialPtr->write(LF);
+#else
+      serialPtr->print("NAK\n");
+#endif
+}
+// **************************************************************
+//                   MEASURE VSYNC RATE
+// **************************************************************
+// Waits for the fps window to fill with frames from the current sensor
+// settings and returns their rate in tenths of fps (0 if VSYNC stopped).
+unsigned int measureVsyncRate() {
+      static const unsigned long TIMEOUT_MS = 2000;
+      unsigned long time0 = millis();
+      uint16_t seq0;
+      uint16_t nFrames;
+
+      noInterrupts();
+      seq0 = frameSeq;
+      interrupts();
+      do {
+          timebase_poll();
+          if (millis() - time0 > TIMEOUT_MS) return 0;
+          noInterrupts();
+          nFrames = frameSeq - seq0;
+          interrupts();
+      } while (nFrames <= FPS_WINDOW);
+      return calcFPS();
+}
+// **************************************************************
+//                      SERIAL EVENT
+// **************************************************************
+// Serial drivers without an RX hook feed the command parser from here.
+#ifndef USE_LEAN_UART
 void serialEvent() {
   while (serialPtr->available()) {
-    // get the new byte:
-    c = serialPtr->read();
-    if (c != LF) {
-            rcvbuf[rcvbufpos++] = c;
-    } else if (c == LF) {
-        rcvbuf[rcvbufpos++] = 0;
-        rcvbufpos = 0;
-        parseSerialBuffer();
-    }
+    cmd_rxByte(serialPtr->read());
   }
 }
+#endif
 
 // *****************************************************
-//               PARSE SERIAL BUFFER
+//               PROCESS COMMANDS
 // ****************************************************
-void parseSerialBuffer(void) {
-       if (strcmp((char *) rcvbuf, "hello") == 0) {
-            serialPtr->print("Hello to you too!\n");
-        } else if ( strlen((char *) rcvbuf) > 5 && 
-                    strncmp((char *) rcvbuf, "send ", 5) == 0) {
-            serialRequest = (serialRequest_t)atoi((char *) (rcvbuf + 5)); 
-            serialPtr->print("ACK\n");
-            bRequestPending = true;       
-        } 
-        else if (strlen((char *) rcvbuf) > 5 &&
-                strncmp((char *) rcvbuf, "dark ", 5) == 0) {
-                  thresh = atoi((char *) (rcvbuf + 5));
-                  serialPtr->print("ACK\n");
-                  serialRequest = SEND_DARK;
-                  bRequestPending = true;
-        }
-        else if (strlen((char *) rcvbuf) > 5 &&
-                strncmp((char *) rcvbuf, "brig ", 5) == 0) {
-                  thresh = atoi((char *) (rcvbuf + 5));
-                  serialPtr->print("ACK\n");
-                  serialRequest = SEND_BRIG;
-                  bRequestPending = true;
-        }
-        else if (strlen((char *) rcvbuf) > 7 &&
-                strncmp((char *) rcvbuf, "thresh ", 7) == 0) {
-                  thresh = atoi((char *) (rcvbuf + 7));
-        }
+// Runs the queued commands in order. Frame requests (CMD_SEND, CMD_DARK,
+// CMD_BRIG) go to the request queue and are answered by the VSYNC
+// handler; commands replying from here wait until that queue is empty,
+// so replies never interleave and come back in the order asked.
+// CMD_SEND arguments processRequest() has a reply for. Others would get a
+// frame header with nothing after it and desync the host: "NAK" instead.
+boolean requestKnown(uint16_t type) {
+  switch (type) {
+    case SEND_0PPB: case SEND_1PPB: case SEND_2PPB: case SEND_4PPB:
+    case SEND_8PPB: case SEND_3BIT: case SEND_5BIT:
+      return true;
+    default:
+      return (type > SEND_NONE && type <= SEND_SPOT) || (type >= SEND_PROJECT && type <= SEND_HWCHECK);
+  }
+}
+// --------------------------------------------------------------
+void queueRequest(serialRequest_t type, uint8_t reqThresh, uint8_t tag) {
+  frameRequest_t &req = reqQueue[reqHead];
+  req.type = type;
+  req.thresh = reqThresh;
+  req.tag = tag;
+  req.decim = decim;
+  req.morph = morphMode;
+  reqHead = (reqHead + 1) & (REQ_QUEUE_LEN - 1); // publish after the entry is complete
+}
+// --------------------------------------------------------------
+void processCommands(void) {
+  cmd_t cmd;
+  while (cmd_peek(cmd)) {
+      uint8_t nQueued = (reqHead - reqTail) & (REQ_QUEUE_LEN - 1);
+      boolean bBadSend = (cmd.op == CMD_SEND && !requestKnown(cmd.arg));
+      boolean bFrameRequest = (cmd.op == CMD_SEND || cmd.op == CMD_DARK || cmd.op == CMD_BRIG) && !bBadSend;
+      boolean bReplies = (cmd.op == CMD_HELLO || cmd.op == CMD_RATE || cmd.op == CMD_STATS ||
+                          cmd.op == CMD_STILL || cmd.op == CMD_TILE || bBadSend);
+      if (bFrameRequest && nQueued == REQ_QUEUE_LEN - 1) break;
+      if (bReplies && nQueued != 0) break;
+      cmd_pop();
+      if (bFrameRequest) still_release(); // the fifo goes back to streaming
+      switch (cmd.op) {
+          case CMD_HELLO:  serialPtr->print("Hello to you too!\n");
+                           break;
+          case CMD_SEND:   if (bBadSend) serialPtr->print("NAK\n");
+                           else queueRequest((serialRequest_t)cmd.arg, thresh, cmd.tag);
+                           break;
+          case CMD_DARK:   queueRequest(SEND_DARK, cmd.arg, cmd.tag);
+                           break;
+          case CMD_BRIG:   queueRequest(SEND_BRIG, cmd.arg, cmd.tag);
+                           break;
+          case CMD_THRESH: thresh = cmd.arg;
+                           break;
+          case CMD_DECIM:  decim = decimSetting(cmd.arg);
+                           break;
+          case CMD_TARGET_FPS: targetFps = cmd.arg;
+                           break;
+          case CMD_COLOR_U: colorRange(colorWin.uMin, colorWin.uMax, cmd.arg);
+                           break;
+          case CMD_COLOR_V: colorRange(colorWin.vMin, colorWin.vMax, cmd.arg);
+                           break;
+          case CMD_COLOR_Y: colorRange(colorWin.yMin, colorWin.yMax, cmd.arg);
+                           break;
+          case CMD_MORPH:  morphMode = cmd.arg <= MORPH_OPEN ? (uint8_t)cmd.arg : (uint8_t)MORPH_NONE;
+                           break;
+          case CMD_SIG:    if ((cmd.arg & 0xFF) < FIFO_SIG_MAX) {
+                               fifo_sigLut_t &next = sigLuts[sigActive ^ 1];
+                               next = sigLuts[sigActive];
+                               fifo_sigSet(next, cmd.arg & 0xFF, (cmd.arg >> 8) ? &colorWin : 0);
+                               sigActive ^= 1;
+                           }
+                           break;
+          case CMD_STILL:  if (cmd.arg) still_capture(cmd.tag);
+                           else still_release();
+                           break;
+          case CMD_TILE:   sendTile(cmd.tag, cmd.arg & 0xFF, cmd.arg >> 8);
+                           break;
+          case CMD_RATE:   // frameRate_t profile: 0=60fps, 1=30fps, 2=15fps, 3=long exposure
+                           if (sensor_setFrameRate((frameRate_t)cmd.arg))
+                               printTenths(measureVsyncRate());
+                           else serialPtr->print("NAK\n");
+                           break;
+          case CMD_STATS:  sendStats();
+                           break;
+          case CMD_AE:     ae_setTarget(cmd.arg); // 0: back to sensor AEC/AGC
+                           break;
+          case CMD_HWRCLK: // hwRclkMode_t mask, only boards with RCLK on a timer output
+#ifdef USE_HW_RCLK
+                           hwRclkModes = cmd.arg;
+#endif
+                           break;
+          default:         break;
+      }
+  }
 }
-
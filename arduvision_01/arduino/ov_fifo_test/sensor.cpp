@@ -15,6 +15,12 @@
 
 #include "delay.h"
 
+static uint8_t sensorPID = 0; // product ID MSB of the detected sensor (0x76 or 0x77)
+
+// vertical frame length in lines (minus margin) limits the exposure time
+static const uint16_t SENSOR_MAX_EXPOSURE = 500;
+static uint16_t dummyLines = 0; // added by the current frame rate profile
+
 uint16_t sensor_init(frameFormat_t fFormat)
 {
     regval_list *format_reglist, *common_reglist;
@@ -53,6 +59,7 @@ uint16_t sensor_init(frameFormat_t fFormat)
       default:    return 0;
                   break;
     }
+    sensorPID = productID >> 8;
     
     sensor_writeReg(resetReg, resetCommand); // reset to default values
     delay(300); // Setting time for register change
@@ -63,6 +70,65 @@ uint16_t sensor_init(frameFormat_t fFormat)
     return productID;
 }
 //**************************
+// Set the sensor clock dividers and dummy lines of a frame rate profile.
+// Returns 0 if the profile or the sensor is unknown.
+uint8_t sensor_setFrameRate(frameRate_t fRate)
+{
+    regval_list *rate_reglist;
+
+    switch(sensorPID) {
+      case 0x76:  switch (fRate) {
+                      case FR_60FPS:   rate_reglist = (regval_list*)rate60_ov7670; break;
+                      case FR_30FPS:   rate_reglist = (regval_list*)rate30_ov7670; break;
+                      case FR_15FPS:   rate_reglist = (regval_list*)rate15_ov7670; break;
+                      case FR_LONGEXP: rate_reglist = (regval_list*)rateLongExp_ov7670; break;
+                      default:         return 0;
+                  }
+                  break;
+      case 0x77:  switch (fRate) {
+                      case FR_60FPS:   rate_reglist = (regval_list*)rate60_ov772x; break;
+                      case FR_30FPS:   rate_reglist = (regval_list*)rate30_ov772x; break;
+                      case FR_15FPS:   rate_reglist = (regval_list*)rate15_ov772x; break;
+                      case FR_LONGEXP: rate_reglist = (regval_list*)rateLongExp_ov772x; break;
+                      default:         return 0;
+                  }
+                  break;
+      default:    return 0;
+    }
+    sensor_writeRegs(rate_reglist);
+    dummyLines = (fRate == FR_LONGEXP) ? 510 : 0;
+    return 1;
+}
+//**************************
+// Change the output size of the running sensor: only the scaling
+// registers are written, the frame rate profile and the exposure stay.
+// The frame being output meanwhile is corrupt. Returns 0 if the format
+// or the sensor is unknown.
+uint8_t sensor_setFormat(frameFormat_t fFormat)
+{
+    regval_list *scale_reglist;
+
+    switch(sensorPID) {
+      case 0x76:  switch (fFormat) {
+                      case FF_QVGA:   scale_reglist = (regval_list*)qvga_scale_ov7670; break;
+                      case FF_QQVGA:  scale_reglist = (regval_list*)qqvga_scale_ov7670; break;
+                      case FF_QQQVGA: scale_reglist = (regval_list*)qqqvga_scale_ov7670; break;
+                      default:        return 0;
+                  }
+                  break;
+      case 0x77:  switch (fFormat) {
+                      case FF_QVGA:   scale_reglist = (regval_list*)qvga_scale_ov772x; break;
+                      case FF_QQVGA:  scale_reglist = (regval_list*)qqvga_scale_ov772x; break;
+                      case FF_QQQVGA: scale_reglist = (regval_list*)qqqvga_scale_ov772x; break;
+                      default:        return 0;
+                  }
+                  break;
+      default:    return 0;
+    }
+    sensor_writeRegs(scale_reglist);
+    return 1;
+}
+//**************************
 // Write byte value regDat to the camera register addressed by regID 
 uint8_t sensor_writeReg(uint8_t regID, uint8_t regDat) {
     Wire.beginTransmission(OV772x_WR_ADDR >> 1);
@@ -123,5 +189,72 @@ void sensor_printlnRegs(const regval_list reglist[], Stream &destPort) {
 	}
 }
 
-
-
+//**************************
+// Hand the exposure and gain control to the sensor (AEC/AGC on) or take it
+// over from the MCU. COM8 has the same address and bits on both sensors.
+void sensor_setAutoExposure(uint8_t bEnable)
+{
+    uint8_t com8 = sensor_readReg(OV7670_REG_COM8);
+    if (bEnable) com8 |= (COM8_AGC | COM8_AEC);
+    else         com8 &= ~(COM8_AGC | COM8_AEC);
+    sensor_writeReg(OV7670_REG_COM8, com8);
+}
+//**************************
+// Exposure time in line periods
+uint16_t sensor_getExposure(void)
+{
+    uint16_t exposure = 0;
+    switch (sensorPID) {
+      case 0x76:  exposure  = (uint16_t)(sensor_readReg(OV7670_REG_AECHH) & 0x3F) << 10;
+                  exposure |= (uint16_t)sensor_readReg(OV7670_REG_AECH) << 2;
+                  exposure |= sensor_readReg(OV7670_REG_COM1) & 0x03;
+                  break;
+      case 0x77:  exposure  = (uint16_t)sensor_readReg(OV772x_REG_AECH) << 8;
+                  exposure |= sensor_readReg(OV772x_REG_AEC);
+                  break;
+      default:    break;
+    }
+    return exposure;
+}
+//**************************
+void sensor_setExposure(uint16_t exposure)
+{
+    switch (sensorPID) {
+      case 0x76:  sensor_writeReg(OV7670_REG_AECHH, (exposure >> 10) & 0x3F);
+                  sensor_writeReg(OV7670_REG_AECH, (exposure >> 2) & 0xFF);
+                  sensor_writeReg(OV7670_REG_COM1,
+                                  (sensor_readReg(OV7670_REG_COM1) & ~0x03) | (exposure & 0x03));
+                  break;
+      case 0x77:  sensor_writeReg(OV772x_REG_AECH, exposure >> 8);
+                  sensor_writeReg(OV772x_REG_AEC, exposure & 0xFF);
+                  break;
+      default:    break;
+    }
+}
+//**************************
+uint16_t sensor_getMaxExposure(void)
+{
+    return SENSOR_MAX_EXPOSURE + dummyLines;
+}
+//**************************
+// Analog gain in 1/16 steps (16 = 1x). Both sensors encode it the same way:
+// gain = (bit7+1)*(bit6+1)*(bit5+1)*(bit4+1)*(1+bits[3:0]/16)
+uint8_t sensor_getGain(void)
+{
+    uint8_t code = sensor_readReg(OV7670_REG_GAIN);
+    uint16_t gain = 16 + (code & 0x0F);
+    for (uint8_t bit = 0x10; bit != 0; bit <<= 1)
+        if (code & bit) gain <<= 1;
+    return (gain > 255) ? 255 : gain;
+}
+//**************************
+void sensor_setGain(uint8_t gain)
+{
+    uint8_t code = 0;
+    if (gain < 16) gain = 16;
+    while ((gain >= 32) && (code < 0x70)) {
+        gain >>= 1;
+        code = (code << 1) | 0x10;
+    }
+    sensor_writeReg(OV7670_REG_GAIN, code | ((gain - 16) & 0x0F));
+}
@@ -15,16 +15,32 @@ struct regval_list {
 };
 enum frameFormat_t {
      FF_QQVGA,
-     FF_QQQVGA  
+     FF_QQQVGA,
+     FF_QVGA     // 320x240 stills only (sensor_setFormat): rows don't fit the row buffer
+};
+enum frameRate_t {
+     FR_60FPS,
+     FR_30FPS,
+     FR_15FPS,
+     FR_LONGEXP,   // ~7.5fps, stretched frame for long exposures
+     FR_NUM_PROFILES
 };
 
 
 uint16_t sensor_init(frameFormat_t fFormat);
+uint8_t sensor_setFrameRate(frameRate_t fRate);
+uint8_t sensor_setFormat(frameFormat_t fFormat);
 void al422_loadFrame(void);
 uint8_t sensor_writeReg(uint8_t regID, uint8_t regDat);
 void sensor_writeRegs(const regval_list reglist[]);
 uint8_t sensor_readReg(uint8_t regID);
 void sensor_printlnRegs(const regval_list reglist[]);
+void sensor_setAutoExposure(uint8_t bEnable);
+uint16_t sensor_getExposure(void);
+void sensor_setExposure(uint16_t exposure);
+uint16_t sensor_getMaxExposure(void);
+uint8_t sensor_getGain(void);
+void sensor_setGain(uint8_t gain);
 void wait(void);
 
 #endif /* _SENSOR_H */
@@ -0,0 +1,50 @@
+/*******************************************************************
+ *
+ *   Part of the ARDUVISION project
+ *
+ *   by David Sanz Kirbis
+ *
+ *  Hot path instrumentation: time spent in each phase of a request
+ *  and in the VSYNC handler, plus overflow counters. Times are Timer1
+ *  ticks (clk/64, the frame timebase), i.e. 64 cpu cycles per tick.
+ *
+ *  The ENABLE_STATS switch lives here, so the sketch and the drivers
+ *  counting into stats (cmd.cpp, uart.h) build with the same setting;
+ *  without it every STATS_ macro compiles to nothing.
+ *
+ ********************************************/
+
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <avr/io.h>
+
+#define ENABLE_STATS // hot path counters and stats command, comment out to compile them out
+
+static const uint8_t STATS_CYCLES_PER_TICK = 64;
+
+// dumped as is (little endian) by the CMD_STATS command
+struct stats_t {
+    uint32_t readTicks;   // clocking data out of the fifo
+    uint32_t txTicks;     // blocked in serial writes
+    uint32_t isrTicks;    // VSYNC handler, when not servicing a request
+    uint16_t nRequests;   // requests serviced
+    uint16_t vsyncBusy;   // VSYNCs that arrived while servicing a request
+    uint16_t rxOverflows; // commands dropped: bad frames, command queue or RX buffer full
+    uint16_t txStalls;    // writes that found the transmit buffer full (lean UART: bytes)
+};
+
+#ifdef ENABLE_STATS
+  extern stats_t stats;
+  #define STATS_START(t)       uint16_t t = TCNT1
+  #define STATS_ADD(field, t)  stats.field += (uint16_t)(TCNT1 - (t))
+  #define STATS_INC(field)     stats.field++
+  #define STATS_INC_BY(field, n) stats.field += (n)
+#else
+  #define STATS_START(t)
+  #define STATS_ADD(field, t)
+  #define STATS_INC(field)
+  #define STATS_INC_BY(field, n)
+#endif
+
+#endif /* _STATS_H */
@@ -0,0 +1,55 @@
+
+#include "uart.h"
+
+LeanUart leanUart;
+
+//**************************
+void LeanUart::begin(unsigned long baud)
+{
+    rxHead = rxTail = rxDroppedCount = 0;
+    UBRR0 = (F_CPU / 4 / baud - 1) / 2; // rounded F_CPU / (8 * baud) - 1
+    UCSR0A = _BV(U2X0);
+    UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); // 8N1
+    UCSR0B = _BV(RXEN0) | _BV(TXEN0) | _BV(RXCIE0);
+}
+//**************************
+int LeanUart::available(void)
+{
+    return (uint8_t)(rxHead - rxTail) & (UART_RX_BUF_LEN - 1);
+}
+//**************************
+int LeanUart::peek(void)
+{
+    if (rxHead == rxTail) return -1;
+    return rxBuf[rxTail];
+}
+//**************************
+int LeanUart::read(void)
+{
+    if (rxHead == rxTail) return -1;
+    uint8_t value = rxBuf[rxTail];
+    rxTail = (rxTail + 1) & (UART_RX_BUF_LEN - 1);
+    return value;
+}
+//**************************
+// there is no TX buffer: just wait until the last byte reaches the shift register
+void LeanUart::flush(void)
+{
+    while (!(UCSR0A & _BV(UDRE0)));
+}
+//**************************
+uint8_t LeanUart::rxDropped(boolean bClear)
+{
+    uint8_t count = rxDroppedCount;
+    if (bClear) rxDroppedCount = 0;
+    return count;
+}
+//**************************
+#if defined(USART0_RX_vect)
+ISR(USART0_RX_vect)
+#else
+ISR(USART_RX_vect)
+#endif
+{
+    leanUart.received(UDR0);
+}
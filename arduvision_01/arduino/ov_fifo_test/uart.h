@@ -0,0 +1,91 @@
+/*******************************************************************
+ *
+ *   Part of the ARDUVISION project
+ *
+ *   by David Sanz Kirbis
+ *
+ *  Lean driver for USART0 (same registers on the 328p and the 2560),
+ *  to be used instead of HardwareSerial / SoftwareSerial:
+ *
+ *   - always runs in double speed mode (U2X), so 500kbps, 1Mbps and
+ *     2Mbps (16MHz only) are exact: UBRR = F_CPU / (8 * baud) - 1
+ *   - transmission is polled and writes UDR0 directly: no TX ring
+ *     buffer, no per byte virtual call, and it works with interrupts
+ *     disabled (i.e. from the VSYNC handler)
+ *   - small interrupt driven RX ring buffer that counts dropped bytes
+ *   - counts the bytes that had to wait for the transmitter in the
+ *     txStalls statistic (see stats.h)
+ *
+ *  The class is final, so calls through a LeanUart pointer are bound at
+ *  compile time and the block write below is inlined into the callers.
+ *  HardwareSerial0 must not be referenced anywhere when this driver is
+ *  in use, as both define the USART0 RX interrupt vector.
+ *
+ ********************************************/
+
+#ifndef _UART_H
+#define _UART_H
+
+#include <Arduino.h>
+#include "stats.h"
+
+static const uint8_t UART_RX_BUF_LEN = 32; // power of 2
+
+class LeanUart final : public Stream {
+  public:
+    void begin(unsigned long baud);
+    virtual int available(void);
+    virtual int peek(void);
+    virtual int read(void);
+    virtual void flush(void);
+    uint8_t rxDropped(boolean bClear);
+    // handler is called in the RX interrupt instead of buffering (NULL: buffer)
+    void onReceive(void (*handler)(uint8_t)) { rxHandler = handler; }
+
+    // a byte finding UDR0 still full counts as a stall (only costs
+    // anything on the path that has to wait anyway)
+    inline void put(uint8_t value) __attribute__((always_inline)) {
+        if (!(UCSR0A & _BV(UDRE0))) {
+            STATS_INC(txStalls);
+            while (!(UCSR0A & _BV(UDRE0)));
+        }
+        UDR0 = value;
+    }
+    // a received byte, from the RX interrupt or from a loop polling UDR0
+    // with interrupts off (see fifo_readRowHw)
+    inline void received(uint8_t value) __attribute__((always_inline)) {
+        if (rxHandler) {
+            rxHandler(value);
+            return;
+        }
+        uint8_t next = (rxHead + 1) & (UART_RX_BUF_LEN - 1);
+        if (next != rxTail) {
+            rxBuf[rxHead] = value;
+            rxHead = next;
+        }
+        else if (rxDroppedCount != 0xFF) rxDroppedCount++;
+    }
+    virtual size_t write(uint8_t value) { put(value); return 1; }
+    virtual size_t write(const uint8_t *buf, size_t len) {
+        size_t n = len;
+        while (n--) put(*buf++);
+        return len;
+    }
+    using Print::write;
+
+    // filled by the RX interrupt
+    volatile uint8_t rxBuf[UART_RX_BUF_LEN];
+    volatile uint8_t rxHead;
+    volatile uint8_t rxTail;
+    volatile uint8_t rxDroppedCount;
+    void (* volatile rxHandler)(uint8_t);
+};
+
+extern LeanUart leanUart;
+
+// row kernel output (see fifo_bufSink in fifo.h) writing straight to UDR0
+struct uart_sink {
+    inline void put(uint8_t value) __attribute__((always_inline)) { leanUart.put(value); }
+};
+
+#endif /* _UART_H */
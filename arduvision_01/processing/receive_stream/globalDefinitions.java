@@ -1,6 +1,6 @@
 
 final class G_DEF {
-                public final static int BAUDRATE = 500000;
+                public final static int BAUDRATE = 1000000; // must match _BAUDRATE in the sketch
 
                 public final static char  LF           = '\n';    // Linefeed in ASCII
                 public final static char  CR           = '\r';    // Carriage return in ASCII
@@ -16,8 +16,52 @@ final class G_DEF {
 
                 public final static int   MAX_ROW_LEN      = F_W*BPP; // pixels + LF character
                 public final static int   MAX_ROW_BUFF_LEN = MAX_ROW_LEN+1; // pixels + LF character
-                public final static int   ACK_BUF_LEN      = 255; // serial buffer to store "ACK"+LF
-                public final static long  SERIAL_TIMEOUT   = 50; // milliseconds to wait for ACK
+                public final static int   N_RATE_PROFILES  = 4;   // firmware CMD_RATE profiles
+                public final static int   AE_TARGET        = 110; // mean Y for the MCU auto exposure loop
+                public final static long  SERIAL_TIMEOUT   = 500; // milliseconds to wait for a reply
+                public final static int   PIPELINE_DEPTH   = 2;   // requests kept in flight (device queues up to 3)
+
+                // binary command frames: CMD_SYNC, opcode, tag, arg low, arg high, check (see cmd.h)
+                public final static int   CMD_SYNC   = 0xA5;
+                public final static int   CMD_HELLO  = 1;
+                public final static int   CMD_SEND   = 2;
+                public final static int   CMD_DARK   = 3;
+                public final static int   CMD_BRIG   = 4;
+                public final static int   CMD_THRESH = 5;
+                public final static int   CMD_RATE   = 6;
+                public final static int   CMD_STATS  = 7;
+                public final static int   CMD_AE     = 8;
+                public final static int   CMD_HWRCLK = 9; // arg: mask of modes read with the Timer1 RCLK engine
+                public final static int   SEND_HWCHECK = 18; // CMD_SEND arg: engine against the software readout, one "HWRCLK" line
+                public final static int   CMD_DECIM  = 10; // arg: factor (1, 2, 4, 8), bit 8 2x2 box average
+                public final static int   CMD_STILL  = 11; // arg: 1 capture and hold a QVGA still, 0 release it
+                public final static int   CMD_TILE   = 12; // arg: tile x | tile y << 8, F_W x F_H YUYV pixels
+                public final static int   CMD_TARGET_FPS = 13; // arg: fps the ADAPTIVE replies pick their packing for
+                public final static int   CMD_COLOR_U = 14; // arg: min | max << 8 of the TRACKCOLOR window
+                public final static int   CMD_COLOR_V = 15;
+                public final static int   CMD_COLOR_Y = 16;
+                public final static int   CMD_SIG     = 17; // arg: signature | 1 << 8 takes the colour window, 0 clears it
+                public final static int   SIG_MAX     = 7;  // signatures the device tracks at once
+                public final static int   CMD_MORPH   = 18; // arg: index in MORPH_NAMES, for the next STREAM8PPB and TRACKDARK requests
+                public final static String[] MORPH_NAMES = { "none", "erode", "dilate", "open" };
+
+                // QVGA stills, read from the device fifo in F_W x F_H tiles
+                public final static int   STILL_W       = 320;
+                public final static int   STILL_H       = 240;
+                public final static int   STILL_TILES_X = STILL_W / F_W;
+                public final static int   STILL_TILES_Y = STILL_H / F_H;
+                public final static long  STILL_TIMEOUT = 2500; // milliseconds, the device gives up after 2s
+
+                public final static int   PROG_ROW_BASE = 0x10; // PROGRESSIVE rows start with their index plus this
+                public final static int   PLANE_LOWEST  = 3;    // BITPLANES stop at D3, the lowest wired data bit
+                public final static int   EGO_MIN_CONF  = 64;   // EGOMOTION shifts less confident than this are not added up
+
+                // TRACKCOLOR windows: U min, U max, V min, V max, Y min, Y max
+                public final static int[][]  COLOR_PRESETS = { { 0x50, 0x78, 0xA0, 0xF0, 0x10, 0xF0 },   // red
+                                                               { 0x40, 0x78, 0x40, 0x78, 0x10, 0xF0 },   // green
+                                                               { 0xA0, 0xF0, 0x60, 0x88, 0x10, 0xF0 },   // blue
+                                                               { 0x20, 0x60, 0x88, 0xB0, 0x40, 0xF0 } }; // yellow
+                public final static String[] COLOR_NAMES   = { "red", "green", "blue", "yellow" };
         }
 
 enum requestStatus_t {
@@ -28,11 +72,27 @@ enum request_t {
     NONE(0),
     TRACKDARK(1), 
     TRACKBRIG(2),
+    STREAMDECIM(4), // every Nth pixel and row, N set with CMD_DECIM
+    PROGRESSIVE(5), // luminance rows in bit reversed order, drawn as they come
+    BITPLANES(6),   // luminance bit planes, MSB first, as many as planeDepth
+    ADAPTIVE(7),    // the device picks the richest packing that holds targetFps
+    LASERLINE(8),   // sub-pixel row of the brightest pixel of each column, over thresh
+    TRACKSPOT(9),   // sub-pixel centroid around the brightest pixel, no threshold
+    PROJECTIONS(11), // sum of Y of every row and column
+    EGOMOTION(12),  // image shift since the last request, from the projections
+    LINEFOLLOW(13), // centre of the longest run under thresh of every row
+    TRACKCOLOR(14), // box, area and centroid of the pixels in the colour window
+    TRACKSIGS(15),  // box and area of every colour signature (the presets)
+    EDGES(16),      // Sobel edge map over thresh, packed as STREAM8PPB
+    EDGES4(17),     // Sobel magnitude, 4 bits packed as STREAM2PPB
     STREAM8PPB(G_DEF.F_W/8),
     STREAM4PPB(G_DEF.F_W/4),
+    STREAM3BIT(G_DEF.F_W*3/8),
     STREAM2PPB(G_DEF.F_W/2),
+    STREAM5BIT(G_DEF.F_W*5/8),
     STREAM1PPB(G_DEF.F_W),
-    STREAM0PPB(G_DEF.F_W*G_DEF.BPP);
+    STREAM0PPB(G_DEF.F_W*G_DEF.BPP),
+    STILLQVGA(0);   // QVGA still assembled from tiles, CMD_STILL / CMD_TILE
     
     private int value;    
 
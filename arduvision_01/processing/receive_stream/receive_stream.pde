@@ -26,8 +26,27 @@ request_t       request;
 requestStatus_t reqStatus = requestStatus_t.IDLE;
 
 // incoming serial 
-byte[]   ackBuff = new byte[G_DEF.ACK_BUF_LEN];
 byte[][] pix     = new byte[G_DEF.F_H][G_DEF.MAX_ROW_LEN];
+byte[]   rowIn   = new byte[G_DEF.MAX_ROW_LEN]; // one reply record, without its LF
+boolean[] rowGot = new boolean[G_DEF.F_H];  // PROGRESSIVE rows received so far
+int[][]  planeY  = new int[G_DEF.F_H][G_DEF.F_W]; // BITPLANES luminance built so far
+int      lowestPlane = 8;                          // and the last plane in it
+int      planeDepth  = 4;     // planes wanted before asking for the next frame (key 'p')
+boolean  bPlanesTail = false; // skipping the rest of a reply cut short
+int      planeLead   = -1;    // first byte of the BITPLANES record coming, -1 not read yet
+float[]  laserRow = new float[G_DEF.F_W]; // LASERLINE sub-pixel row of each column, -1 none
+PVector  spot     = new PVector(0,0);        // TRACKSPOT sub-pixel centroid
+int      spotPeak = 0;                       // and its peak Y
+int[]    rowProfile = new int[G_DEF.F_H];     // PROJECTIONS sum of Y of each row
+int[]    colProfile = new int[G_DEF.F_W];     // and of each column
+PVector  egoShift = new PVector(0,0);        // EGOMOTION image shift of the last reply, pixels
+int      egoConfX = 0, egoConfY = 0;         // and its confidence, 0..255
+PVector  egoPos   = new PVector(0,0);        // shifts added up while confident
+int[]    lineCentre = new int[G_DEF.F_H];     // LINEFOLLOW centre column of each row, -1 no line
+int      colorArea  = 0;                      // TRACKCOLOR blob area, pixels
+PVector  colorCentre = new PVector(0,0);      // and centroid
+int      colorPreset = 0;                     // window sent to the device (key 'c')
+int[][]  sigBox  = new int[G_DEF.SIG_MAX][5]; // TRACKSIGS x0, y0, x1, y1, area of each signature
 
 double waitTimeout    = 0;
 double fpsTimeStamp   = 0;
@@ -35,16 +54,48 @@ double fpsTimeStamp   = 0;
 PFont  myFont;
 PImage currFrame;
 
+// QVGA still assembled from the tiles the device reads from its fifo
+byte[][] stillPix  = new byte[G_DEF.STILL_H][G_DEF.STILL_W*G_DEF.BPP];
+PImage   stillFrame;
+int      stillTile = -1; // next tile to ask for, -1 while the capture is pending
+
 boolean bSerialDebug = true;
 
 int currRow = 0;
+
+// requests in flight: each one carries a tag the device echoes in the
+// reply header, so replies are matched to what was asked even across mode changes
+int         inFlight   = 0;
+int         nextTag    = 0;
+request_t[] tagRequest = new request_t[256];
+request_t   rxRequest  = request_t.NONE; // request of the reply being received
+
+// frame header sent by the device ahead of every reply: "T <seq> <capture us> <dropped> <tag>"
+int     frameSeq       = 0;
+long    frameTime      = 0;     // device timebase, microseconds
+int     droppedFrames  = 0;
+int     rxDecim        = 1;     // decimation of the reply being received
+int     frameDecim     = 1;     // and of the last one completed
+request_t rxEncoding   = request_t.NONE; // packing of the reply being received (ADAPTIVE)
+request_t frameEncoding = request_t.NONE; // and of the last one completed
+int     targetFps      = 15;    // ADAPTIVE mode target (key 't')
+final int[] TARGET_FPS_STEPS = {5, 10, 15, 20, 30};
+long    minClockDiff   = Long.MAX_VALUE;
+float   latency        = 0;     // ms, over the best latency seen so far
 byte thresh  = (byte)130;
+int  sentThresh = -1;    // last CMD_THRESH value sent, -1 to send it again
 
 PVector lastCenter = new PVector(0,0);
 float tmp_x0 = 0, tmp_y0 = 0, tmp_x1 = 0, tmp_y1 = 0;
 float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
 
 boolean bKalmanEnabled = true;
+boolean bAutoExposure  = false; // MCU side auto exposure loop
+boolean bHwRclk        = false; // hardware RCLK readout, boards with RCLK on OC1A only
+int     decimFactor    = 1;     // device side decimation: STREAMDECIM, coarse to fine tracking
+boolean bDecimBox      = false; // 2x2 box average the decimated pixels
+int     morphMode      = 0;     // 3x3 cleaning of the 8ppb mask and dark box: none, erode, dilate, open
+int     rateProfile    = 1;     // sensor frame rate profile: 0=60fps, 1=30fps, 2=15fps, 3=long exposure
 simpleKalman filter_x0 = new simpleKalman();
 simpleKalman filter_y0 = new simpleKalman();
 simpleKalman filter_x1 = new simpleKalman();
@@ -59,6 +110,7 @@ void setup() {
   frameRate(99);
   noSmooth();  
   currFrame = createImage(G_DEF.F_W, G_DEF.F_H, RGB);
+  stillFrame = createImage(G_DEF.STILL_W, G_DEF.STILL_H, RGB);
   
   
   // create a font with the third font available to the system:
@@ -75,59 +127,114 @@ void setup() {
   delay(2000);
   reqStatus = reqStatus.IDLE;
   request = request.NONE;
+  sendCommand(G_DEF.CMD_TARGET_FPS, 0, targetFps);
+  // the colour presets as signatures, then back to the current one
+  for (int k = 0; k < G_DEF.COLOR_PRESETS.length && k < G_DEF.SIG_MAX; k++) {
+      sendColorWindow(k);
+      sendCommand(G_DEF.CMD_SIG, 0, k | (1 << 8));
+      delay(10); // the device queues only a few commands
+  }
+  sendColorWindow(colorPreset);
 }
   
 // ************************************************************
 //                          DRAW
 // ************************************************************
 void draw() {
+  pumpSerial(); // records that came while the last reply was held
   switch (request) {
     case NONE:        reqStatus = requestStatus_t.IDLE;
                       background(0);
                       drawInfo();
                        break;
     case TRACKDARK: 
-    case TRACKBRIG:    switch (reqStatus) {
-                            case RECEIVED:  drawTracking();
+    case TRACKBRIG:
+    case LASERLINE:
+    case TRACKSPOT:
+    case PROJECTIONS:
+    case EGOMOTION:
+    case LINEFOLLOW:
+    case TRACKCOLOR:
+    case TRACKSIGS:    switch (reqStatus) {
+                            case RECEIVED:  if (request == request_t.LASERLINE) drawLaserLine();
+                                            else if (request == request_t.TRACKSPOT) drawSpot();
+                                            else if (request == request_t.PROJECTIONS) drawProjections();
+                                            else if (request == request_t.EGOMOTION) drawEgoMotion();
+                                            else if (request == request_t.LINEFOLLOW) drawLineFollow();
+                                            else if (request == request_t.TRACKCOLOR) drawColorBlob();
+                                            else if (request == request_t.TRACKSIGS) drawSignatures();
+                                            else drawTracking();
                                             drawFPS();
-                                            reqStatus = requestStatus_t.IDLE;
+                                            reqStatus = requestStatus_t.REQUESTED;
                                             break;
-                            case TIMEOUT:   
-                            case IDLE:      reqTracking(request);
-                                            reqStatus = requestStatus_t.REQUESTED; 
-                                            waitTimeout = G_DEF.SERIAL_TIMEOUT + millis();
+                            case TIMEOUT:   inFlight = 0; sentThresh = -1; // replies lost, start over
+                                            serialPort.clear();
+                            case IDLE:      reqStatus = requestStatus_t.REQUESTED; 
                                             break;
                             case REQUESTED:  if (millis() > waitTimeout) reqStatus = requestStatus_t.TIMEOUT;
                                             break;
                             case ARRIVING:  break;
                             default : break;
                        }
+                       fillPipeline(request);
                        drawInfo();
                        break;
      case STREAM0PPB:
      case STREAM1PPB:
      case STREAM2PPB:
      case STREAM4PPB:
+     case STREAM3BIT:
+     case STREAM5BIT:
+     case STREAMDECIM:
+     case PROGRESSIVE:
+     case BITPLANES:
+     case ADAPTIVE:
+     case EDGES:
+     case EDGES4:
      case STREAM8PPB:  switch (reqStatus) {
                             case RECEIVED:  reqStatus = requestStatus_t.PROCESSING;
                                             buff2pixFrame(pix, currFrame, request);
                                             image(currFrame,0,0, G_DEF.F_W*G_DEF.DRAW_SCALE,G_DEF.F_H*G_DEF.DRAW_SCALE);
                                             drawFPS();
-                                            reqStatus = requestStatus_t.IDLE;
+                                            reqStatus = requestStatus_t.REQUESTED;
                                             break;
-                            case TIMEOUT:   
-                            case IDLE:      reqImage(request);
-                                            reqStatus = requestStatus_t.REQUESTED; 
-                                            waitTimeout = G_DEF.SERIAL_TIMEOUT + millis();
+                            case TIMEOUT:   inFlight = 0; sentThresh = -1; // replies lost, start over
+                                            serialPort.clear();
+                            case IDLE:      reqStatus = requestStatus_t.REQUESTED; 
                                             break;
                             case REQUESTED:  if (millis() > waitTimeout) reqStatus = requestStatus_t.TIMEOUT;
                                             break;
-                            case ARRIVING:  break;
+                            case ARRIVING:  if ((request == request_t.PROGRESSIVE || request == request_t.BITPLANES) && rxRequest == request) {
+                                                buff2pixFrame(pix, currFrame, request); // refined as rows come
+                                                image(currFrame,0,0, G_DEF.F_W*G_DEF.DRAW_SCALE,G_DEF.F_H*G_DEF.DRAW_SCALE);
+                                            }
+                                            break;
                             case PROCESSING:  break;
                             default : break;
                           }   
+                      fillPipeline(request);
                       drawInfo();
                       break;
+     case STILLQVGA:   switch (reqStatus) {
+                            case RECEIVED:  if (stillTile < G_DEF.STILL_TILES_X*G_DEF.STILL_TILES_Y) {
+                                                reqStill(stillTile);
+                                                break;
+                                            }
+                                            reqStatus = requestStatus_t.PROCESSING; // shown until the mode changes
+                                            buff2still(stillPix, stillFrame);
+                                            stillFrame.save("still-"+nf(frameSeq, 5)+".png");
+                                            image(stillFrame, 0, 0, G_DEF.SCR_W, G_DEF.SCR_H);
+                                            break;
+                            case TIMEOUT:   inFlight = 0; sentThresh = -1; // replies lost, start over
+                                            serialPort.clear();
+                            case IDLE:      reqStill(-1);
+                                            break;
+                            case REQUESTED:  if (millis() > waitTimeout) reqStatus = requestStatus_t.TIMEOUT;
+                                            break;
+                            default : break;
+                       }
+                       drawInfo();
+                       break;
       default :        break;
     }                                       
 }
@@ -136,77 +243,407 @@ void draw() {
 //                     SERIAL EVENT HANDLER
 // ************************************************************
 void serialEvent(Serial serialPort) {
+    pumpSerial();
+}
+
+// ************************************************************
+//                       PUMP SERIAL
+// ************************************************************
+// Parses every complete record already buffered, leaving the rest for
+// later. With PIPELINE_DEPTH requests queued the next reply follows the
+// current one right away, so nothing is thrown away but on a record that
+// does not end in a LF (see resync). Called from the serial thread on each
+// LF and from draw() once a frame is drawn, as the records of the next
+// reply may have come in while it was held.
+synchronized void pumpSerial() {
+    while (parseSerialRecord());
+}
 
-    if (reqStatus == requestStatus_t.REQUESTED) {
-          int numBytesRead = serialPort.readBytesUntil(G_DEF.LF, ackBuff);
-          if ((numBytesRead >= 4) && 
-              (ackBuff[numBytesRead-4] == 'A') &&
-              (ackBuff[numBytesRead-3] == 'C') &&
-              (ackBuff[numBytesRead-2] == 'K') ) {
-            reqStatus = requestStatus_t.ARRIVING;
-          } else if (millis() > waitTimeout) {
-            reqStatus = requestStatus_t.TIMEOUT;
+boolean parseSerialRecord() {
+    if (bPlanesTail) {
+          // planes sent after the host had enough, up to the end of the reply
+          byte[] rec = readPlaneRecord();
+          if (rec == null) return false;
+          if (rec[0] == 'E') bPlanesTail = false;
+    }
+    else if (reqStatus == requestStatus_t.REQUESTED) {
+          // the reply header doubles as the acknowledge
+          String line = serialPort.readStringUntil(G_DEF.LF);
+          if (line == null) return false;
+          if (parseFrameHeader(line)) {
+            if (rxRequest == request_t.STILLQVGA && stillTile < 0) {
+                stillTile = 0; // still held on the device, the header is the whole reply
+                replyDone();
+            }
+            else {
+                reqStatus = requestStatus_t.ARRIVING;
+                if (rxRequest == request_t.PROGRESSIVE) Arrays.fill(rowGot, false);
+                if (rxRequest == request_t.BITPLANES) {
+                    for (int[] row : planeY) Arrays.fill(row, 0);
+                    lowestPlane = 8;
+                }
+                currRow = 0;
+                waitTimeout = G_DEF.SERIAL_TIMEOUT + millis();
+            }
           }
+          else if (bSerialDebug || line.startsWith("HWRCLK")) print(line);
     }
     else if (reqStatus == requestStatus_t.ARRIVING) {
-        parseSerialData();
+        return parseSerialData();
+    }
+    else if (reqStatus == requestStatus_t.RECEIVED || reqStatus == requestStatus_t.PROCESSING) {
+        return false; // next reply already coming: leave it buffered until the last one is drawn
     }
     else {
-      if (bSerialDebug) print(serialPort.readStringUntil(G_DEF.LF)); 
+      String line = serialPort.readStringUntil(G_DEF.LF);
+      if (line == null) return false;
+      if (bSerialDebug || line.startsWith("HWRCLK")) print(line);
     }
+    return true;
 }
 
+// ************************************************************
+//                       RESYNC
+// ************************************************************
+// A record out of step with the reply: drop whatever is buffered and
+// start over as on a timeout, the next header puts the host back in sync.
+void resync() {
+  serialPort.clear();
+  planeLead = -1;
+  bPlanesTail = false;
+  reqStatus = requestStatus_t.TIMEOUT;
+}
+
+// ************************************************************
+//                       RECORD LENGTH
+// ************************************************************
+// Bytes of the next record of the reply being received, LF not counted
+int recordLength() {
+  switch (rxRequest) {
+      case TRACKDARK:
+      case TRACKBRIG:
+      case EGOMOTION:    return 4;
+      case LASERLINE:    return G_DEF.F_W*2;
+      case TRACKSPOT:    return 5;
+      case PROJECTIONS:  return (currRow == 0 ? G_DEF.F_H : G_DEF.F_W)*2;
+      case TRACKCOLOR:   return 8;
+      case TRACKSIGS:    return G_DEF.SIG_MAX*6;
+      case LINEFOLLOW:   return G_DEF.F_H;
+      case STREAMDECIM:  return G_DEF.F_W/rxDecim;
+      case EDGES:        return request_t.STREAM8PPB.getParam();
+      case EDGES4:       return request_t.STREAM2PPB.getParam();
+      case PROGRESSIVE:  return G_DEF.F_W + 1;
+      case STILLQVGA:    return G_DEF.MAX_ROW_LEN;
+      default:           return rxEncoding.getParam(); // ADAPTIVE and the stream modes
+  }
+}
+
+int rxU8(int i)  { return rowIn[i] & 0xFF; }
+int rxU16(int i) { return rxU8(i) | (rxU8(i+1) << 8); }
+
 // ************************************************************
 //                       PARSE SERIAL DATA
 // ************************************************************
-void parseSerialData() {
-  switch (request) {
+// One record of the reply into rowIn, then decoded. Binary records may
+// hold a LF, so they are only taken once all their bytes are in.
+boolean parseSerialData() {
+  if (rxRequest == request_t.BITPLANES) {
+      byte[] rec = readPlaneRecord();
+      if (rec == null) return false;
+      parsePlaneRow(rec);
+      return true;
+  }
+  int len = recordLength();
+  if (serialPort.available() < len + 1) return false; // a LF in the data, more to come
+  for (int i = 0; i < len; i++) rowIn[i] = (byte)serialPort.read();
+  if (serialPort.read() != G_DEF.LF) {
+      resync();
+      return false;
+  }
+  switch (rxRequest) {
       case NONE:         break;
       case TRACKDARK: 
-      case TRACKBRIG:     tmp_x0 = int(serialPort.read());
-                          tmp_y0 = int(serialPort.read());
-                          tmp_x1 = int(serialPort.read());
-                          tmp_y1 = int(serialPort.read());
-                          reqStatus = requestStatus_t.RECEIVED;
+      case TRACKBRIG:     tmp_x0 = rxU8(0);
+                          tmp_y0 = rxU8(1);
+                          tmp_x1 = rxU8(2);
+                          tmp_y1 = rxU8(3);
+                          replyDone();
+                          break;
+       case LASERLINE:    for (int x = 0; x < G_DEF.F_W; x++) {
+                             int value = rxU16(x*2);
+                             laserRow[x] = (value == 0xFFFF) ? -1 : value / 256.0;
+                          }
+                          replyDone();
+                          break;
+       case TRACKSPOT:    spot.x = rxU16(0) / 256.0;
+                          spot.y = rxU16(2) / 256.0;
+                          spotPeak = rxU8(4);
+                          replyDone();
+                          break;
+       case PROJECTIONS:  if (currRow == 0) {
+                              for (int y = 0; y < G_DEF.F_H; y++) rowProfile[y] = rxU16(y*2);
+                              currRow++;
+                              break;
+                          }
+                          for (int x = 0; x < G_DEF.F_W; x++) colProfile[x] = rxU16(x*2);
+                          currRow = 0;
+                          replyDone();
+                          break;
+       case EGOMOTION:    egoShift.x = rowIn[0] / 8.0;
+                          egoShift.y = rowIn[1] / 8.0;
+                          egoConfX = rxU8(2);
+                          egoConfY = rxU8(3);
+                          if (egoConfX > G_DEF.EGO_MIN_CONF) egoPos.x += egoShift.x;
+                          if (egoConfY > G_DEF.EGO_MIN_CONF) egoPos.y += egoShift.y;
+                          replyDone();
+                          break;
+       case TRACKCOLOR:   tmp_x0 = rxU8(0);
+                          tmp_y0 = rxU8(1);
+                          tmp_x1 = rxU8(2);
+                          tmp_y1 = rxU8(3);
+                          colorArea = rxU16(4);
+                          colorCentre.x = rxU8(6);
+                          colorCentre.y = rxU8(7);
+                          replyDone();
+                          break;
+       case TRACKSIGS:    for (int k = 0; k < G_DEF.SIG_MAX; k++) {
+                             for (int i = 0; i < 4; i++) sigBox[k][i] = rxU8(k*6 + i);
+                             sigBox[k][4] = rxU16(k*6 + 4);
+                          }
+                          replyDone();
+                          break;
+       case LINEFOLLOW:   for (int y = 0; y < G_DEF.F_H; y++) {
+                             int c = rxU8(y);
+                             lineCentre[y] = (c == 0xFF) ? -1 : c;
+                          }
+                          replyDone();
                           break;
        case STREAM0PPB:
        case STREAM1PPB:
        case STREAM2PPB:
        case STREAM4PPB:
-       case STREAM8PPB:   serialPort.readBytes(pix[currRow]);
-                          serialPort.clear();
+       case STREAM3BIT:
+       case STREAM5BIT:
+       case STREAMDECIM:
+       case ADAPTIVE:
+       case EDGES:
+       case EDGES4:
+       case STREAM8PPB:   arrayCopy(rowIn, 0, pix[currRow], 0, len);
                           currRow++;
-                          if (currRow >= G_DEF.F_H) {
-                              reqStatus = requestStatus_t.RECEIVED; // frame ready on buffer
+                          if (currRow >= (G_DEF.F_H + rxDecim - 1)/rxDecim) {
+                              frameDecim = rxDecim;
+                              frameEncoding = rxEncoding;
+                              replyDone(); // frame ready on buffer
                               currRow = 0;
                               if (bSerialDebug) println();
                           }
                         break;
+       case PROGRESSIVE:  int r = rxU8(0) - G_DEF.PROG_ROW_BASE;
+                          if (r >= 0 && r < G_DEF.F_H) {
+                              arrayCopy(rowIn, 1, pix[r], 0, G_DEF.F_W);
+                              rowGot[r] = true;
+                          }
+                          currRow++;
+                          if (currRow >= G_DEF.F_H) {
+                              replyDone();
+                              currRow = 0;
+                          }
+                        break;
+       case STILLQVGA:    arrayCopy(rowIn, 0,
+                                    stillPix[(stillTile / G_DEF.STILL_TILES_X)*G_DEF.F_H + currRow],
+                                    (stillTile % G_DEF.STILL_TILES_X)*G_DEF.MAX_ROW_LEN, G_DEF.MAX_ROW_LEN);
+                          currRow++;
+                          if (currRow >= G_DEF.F_H) {
+                              stillTile++;
+                              replyDone();
+                              currRow = 0;
+                          }
+                        break;
         default :       break;
     }      
-    
+    return true;
+}
+  
+// ************************************************************
+//                      READ BIT PLANE RECORD
+// ************************************************************
+// '<plane digit>' '<row + PROG_ROW_BASE>' F_W/8 bytes LF, or "E" LF at the
+// end of the reply, read at their exact length as the packed bits may hold
+// a LF. The first byte tells which one comes: it waits in planeLead until
+// the rest is in. Returns the record without its LF, null if incomplete or
+// out of step (resync).
+byte[] readPlaneRecord() {
+  if (planeLead < 0) {
+      if (serialPort.available() < 1) return null;
+      planeLead = serialPort.read();
+  }
+  boolean bEnd = (planeLead == 'E');
+  if (!bEnd && (planeLead < '0' + G_DEF.PLANE_LOWEST || planeLead > '7')) {
+      resync();
+      return null;
+  }
+  int len = bEnd ? 1 : G_DEF.F_W/8 + 2; // bytes after the first one, LF included
+  if (serialPort.available() < len) return null;
+  byte[] rec = new byte[len];
+  rec[0] = (byte)planeLead;
+  for (int i = 1; i < len; i++) rec[i] = (byte)serialPort.read();
+  planeLead = -1;
+  if (serialPort.read() != G_DEF.LF) {
+      resync();
+      return null;
+  }
+  return rec;
+}
+
+// ************************************************************
+//                      PARSE BIT PLANE ROW
+// ************************************************************
+// A record from readPlaneRecord(). Once planeDepth planes are in, the
+// frame is taken as received: the next request makes the device stop
+// after its current plane, whose rows are skipped up to the "E".
+void parsePlaneRow(byte[] rec) {
+  if (rec[0] == 'E') {
+      replyDone();
+      return;
+  }
+  int plane = rec[0] - '0';
+  int r = (rec[1] & 0xFF) - G_DEF.PROG_ROW_BASE;
+  if (r < 0 || r >= G_DEF.F_H) {
+      resync();
+      return;
+  }
+  for (int x = 0; x < G_DEF.F_W; x++)
+     if ((rec[2 + (x >> 3)] & (1 << (x & 7))) != 0) planeY[r][x] |= 1 << plane;
+  lowestPlane = min(lowestPlane, plane);
+  if (r == G_DEF.F_H-1 && 8 - plane >= planeDepth && plane > G_DEF.PLANE_LOWEST) {
+      bPlanesTail = true;
+      replyDone();
+  }
+}
+  
+// ************************************************************
+//                       REPLY DONE
+// ************************************************************
+// Replies to a request of a previous mode are just dropped.
+void replyDone() {
+  if (inFlight > 0) inFlight--;
+  if (rxRequest == request) reqStatus = requestStatus_t.RECEIVED;
+  else reqStatus = requestStatus_t.REQUESTED;
 }
   
+// ************************************************************
+//                     PARSE FRAME HEADER
+// ************************************************************
+// "T <seq> <capture us> <dropped> <tag> <decimation>", returns false for any other line
+boolean parseFrameHeader(String line) {
+  if (line == null) return false;
+  String[] fields = splitTokens(trim(line), " ");
+  if (fields.length < 5 || !fields[0].equals("T")) return false;
+  frameSeq      = int(fields[1]);
+  frameTime     = Long.parseLong(fields[2]);
+  droppedFrames = int(fields[3]);
+  rxRequest     = tagRequest[int(fields[4]) & 0xFF];
+  if (rxRequest == null) rxRequest = request_t.NONE;
+  rxDecim       = fields.length > 5 ? max(1, int(fields[5])) : 1;
+  rxEncoding    = fields.length > 6 ? encodingOf(int(fields[6])) : rxRequest;
+  // the device clock runs on its own: track the smallest host-device
+  // difference seen and report latency over it
+  long clockDiff = System.nanoTime()/1000 - frameTime;
+  if (clockDiff < minClockDiff) minClockDiff = clockDiff;
+  latency = (clockDiff - minClockDiff)/1000.0;
+  return true;
+}
+
+// ************************************************************
+//                      ENCODING OF A REPLY
+// ************************************************************
+// The stream mode whose CMD_SEND argument is the header encoding field
+request_t encodingOf(int value) {
+  request_t[] streams = { request_t.STREAM0PPB, request_t.STREAM1PPB, request_t.STREAM5BIT, request_t.STREAM2PPB,
+                          request_t.STREAM3BIT, request_t.STREAM4PPB, request_t.STREAM8PPB };
+  for (request_t r : streams)
+     if (r.getParam() == value) return r;
+  return request_t.NONE;
+}
+
+// ************************************************************
+//                      FILL PIPELINE
+// ************************************************************
+// Keeps PIPELINE_DEPTH requests queued on the device, so the next frame
+// is already asked for while the current one is being transferred.
+void fillPipeline(request_t req) {
+  // bit planes stop when the next request arrives: one at a time
+  int depth = (req == request_t.BITPLANES) ? 1 : G_DEF.PIPELINE_DEPTH;
+  while (inFlight < depth) {
+      int tag = nextTag;
+      nextTag = (nextTag+1) & 0xFF;
+      tagRequest[tag] = req;
+      if (req == request_t.TRACKDARK || req == request_t.TRACKBRIG) reqTracking(req, tag);
+      else reqImage(req, tag);
+      inFlight++;
+      waitTimeout = G_DEF.SERIAL_TIMEOUT + millis();
+  }
+}
+
 // ************************************************************
 //                      REQUEST IMAGE
 // ************************************************************
-void reqImage(request_t req) {
-      currRow = 0;
-      serialPort.clear();
-      serialPort.write("thresh "+Integer.toString(int(thresh))+G_DEF.LF);
-      serialPort.write("send "+Integer.toString(req.getParam())+G_DEF.LF);
+// The threshold sticks on the device: sent only when it changed, so a
+// request costs one command slot there (the queue fills while a frame
+// is being sent).
+void reqImage(request_t req, int tag) {
+      if ((int(thresh) & 0xFF) != sentThresh) {
+          sentThresh = int(thresh) & 0xFF;
+          sendCommand(G_DEF.CMD_THRESH, 0, sentThresh);
+      }
+      sendCommand(G_DEF.CMD_SEND, tag, req.getParam());
+}
+  
+// ************************************************************
+//                      REQUEST STILL
+// ************************************************************
+// tile < 0: capture a new still on the device, otherwise ask for that
+// tile of the held one (row major).
+void reqStill(int tile) {
+      int tag = nextTag;
+      nextTag = (nextTag+1) & 0xFF;
+      tagRequest[tag] = request_t.STILLQVGA;
+      if (tile < 0) {
+          stillTile = -1;
+          sendCommand(G_DEF.CMD_STILL, tag, 1);
+          waitTimeout = G_DEF.STILL_TIMEOUT + millis();
+      }
+      else {
+          sendCommand(G_DEF.CMD_TILE, tag, (tile % G_DEF.STILL_TILES_X) | ((tile / G_DEF.STILL_TILES_X) << 8));
+          waitTimeout = G_DEF.SERIAL_TIMEOUT + millis();
+      }
+      inFlight++;
+      reqStatus = requestStatus_t.REQUESTED;
+}
+  
+// ************************************************************
+//                      SEND COMMAND
+// ************************************************************
+void sendCommand(int op, int tag, int arg) {
+      byte[] frame = new byte[6];
+      frame[0] = (byte)G_DEF.CMD_SYNC;
+      frame[1] = (byte)op;
+      frame[2] = (byte)tag;
+      frame[3] = (byte)(arg & 0xFF);
+      frame[4] = (byte)((arg >> 8) & 0xFF);
+      frame[5] = (byte)(frame[0] ^ frame[1] ^ frame[2] ^ frame[3] ^ frame[4]);
+      serialPort.write(frame);
 }
   
 // ************************************************************
 //                  REQUEST TRACKING DATA
 // ************************************************************
-void reqTracking(request_t req) {
+void reqTracking(request_t req, int tag) {
     
-      serialPort.clear();
       if (req == request_t.TRACKDARK)
-          serialPort.write("dark "+Integer.toString(int(thresh))+G_DEF.LF);
+          sendCommand(G_DEF.CMD_DARK, tag, int(thresh) & 0xFF);
       else if (req == request_t.TRACKBRIG)
-          serialPort.write("brig "+Integer.toString(int(thresh))+G_DEF.LF);
+          sendCommand(G_DEF.CMD_BRIG, tag, int(thresh) & 0xFF);
        
 }
   
@@ -224,7 +661,7 @@ void drawInfo() {
    textAlign(LEFT, TOP);
    text(modeStr, 20, height-G_DEF.FONT_BKG_SIZE);
    textAlign(RIGHT, TOP);
-   text("thresh (+/-): "+int(thresh), width-20, height-G_DEF.FONT_BKG_SIZE);
+   text("morph (m): "+G_DEF.MORPH_NAMES[morphMode]+"  decim (d/b): "+decimFactor+(bDecimBox ? " box" : "")+"  thresh (+/-): "+int(thresh), width-20, height-G_DEF.FONT_BKG_SIZE);
    popMatrix();
    popStyle();
 }
@@ -235,16 +672,18 @@ void drawInfo() {
 void drawFPS() {
    long currTime = millis();
    float fps =1000.0/(float)(currTime-fpsTimeStamp);
+   String fpsStr = "FPS: "+fps+"  lat(ms): "+latency+"  dropped: "+droppedFrames;
+   if (request == request_t.ADAPTIVE) fpsStr += "  target (t): "+targetFps+"  enc: "+frameEncoding;
    
    pushStyle();
    pushMatrix();
    noStroke();
    fill(0);
-   rect(20, 20, textWidth("FPS: "+fps), G_DEF.FONT_SIZE);
+   rect(20, 20, textWidth(fpsStr), G_DEF.FONT_SIZE);
    fill(255);
    translate(0,-2);
    textAlign(LEFT, TOP);
-   text("FPS: "+fps, 20, 20);
+   text(fpsStr, 20, 20);
    popMatrix();
    popStyle();
    fpsTimeStamp = currTime;
@@ -303,6 +742,162 @@ void drawTracking() {
    popStyle();
 }
 
+// ************************************************************
+//                      DRAW LASER LINE
+// ************************************************************
+// Profile of the line laser: the sub-pixel row of each column, joined
+// across the columns where the device found it.
+void drawLaserLine() {
+   background(0);
+   pushStyle();
+   stroke(255,0,0);
+   strokeWeight(3);
+   for (int x = 1; x < G_DEF.F_W; x++)
+      if (laserRow[x-1] >= 0 && laserRow[x] >= 0)
+         line((x-0.5)*G_DEF.DRAW_SCALE, (laserRow[x-1]+0.5)*G_DEF.DRAW_SCALE,
+              (x+0.5)*G_DEF.DRAW_SCALE, (laserRow[x]+0.5)*G_DEF.DRAW_SCALE);
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW BRIGHTEST SPOT
+// ************************************************************
+void drawSpot() {
+   float centX = (spot.x+0.5)*G_DEF.DRAW_SCALE;
+   float centY = (spot.y+0.5)*G_DEF.DRAW_SCALE;
+   background(0);
+   pushStyle();
+   noFill();
+   strokeWeight(3);
+   stroke(spotPeak);
+   ellipse(centX, centY, 40, 40);
+   stroke(255,0,0);
+   line(centX-10, centY, centX+10, centY);
+   line(centX, centY-10, centX, centY+10);
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW PROJECTIONS
+// ************************************************************
+// Mean Y of each column as bars up from the bottom, of each row as bars
+// from the left.
+void drawProjections() {
+   float scale = G_DEF.DRAW_SCALE;
+   background(0);
+   pushStyle();
+   noStroke();
+   fill(0,255,0,160);
+   for (int x = 0; x < G_DEF.F_W; x++) {
+      float h = colProfile[x] / (255.0*G_DEF.F_H) * G_DEF.F_H*scale;
+      rect(x*scale, G_DEF.F_H*scale - h, scale, h);
+   }
+   fill(255,0,0,160);
+   for (int y = 0; y < G_DEF.F_H; y++)
+      rect(0, y*scale, rowProfile[y] / (255.0*G_DEF.F_W) * G_DEF.F_W*scale, scale);
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW EGO-MOTION
+// ************************************************************
+// The image shifts added up since the receiver started, wrapped around
+// the screen, and the shift and confidence of the last reply.
+void drawEgoMotion() {
+   float scale = G_DEF.DRAW_SCALE;
+   float posX = ((egoPos.x*scale % G_DEF.SCR_W) + G_DEF.SCR_W*1.5) % G_DEF.SCR_W;
+   float posY = ((egoPos.y*scale % G_DEF.SCR_H) + G_DEF.SCR_H*1.5) % G_DEF.SCR_H;
+   background(0);
+   pushStyle();
+   strokeWeight(3);
+   stroke(255,0,0);
+   line(posX-10, posY, posX+10, posY);
+   line(posX, posY-10, posX, posY+10);
+   stroke(0,0,255);
+   line(posX, posY, posX + egoShift.x*scale, posY + egoShift.y*scale);
+   fill(255);
+   textAlign(LEFT, TOP);
+   text("dx: "+egoShift.x+" ("+egoConfX+")  dy: "+egoShift.y+" ("+egoConfY+")", 20, 50);
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW LINE FOLLOWING
+// ************************************************************
+// The guide line centre of each row and, as the steering signal, how far
+// its mean is from the middle of the frame.
+void drawLineFollow() {
+   float scale = G_DEF.DRAW_SCALE;
+   int sum = 0, n = 0;
+   background(0);
+   pushStyle();
+   noStroke();
+   fill(255,0,0);
+   for (int y = 0; y < G_DEF.F_H; y++)
+      if (lineCentre[y] >= 0) {
+         rect(lineCentre[y]*scale, y*scale, scale, scale);
+         sum += lineCentre[y];
+         n++;
+      }
+   if (n > 0) {
+      float steer = (float)sum/n + 0.5 - G_DEF.F_W/2.0;
+      stroke(0,0,255);
+      strokeWeight(3);
+      line(G_DEF.SCR_W/2, G_DEF.SCR_H - 20, G_DEF.SCR_W/2 + steer*scale, G_DEF.SCR_H - 20);
+   }
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW COLOUR BLOB
+// ************************************************************
+// The blob box as the dark/bright trackers, with its centroid and area.
+void drawColorBlob() {
+   drawTracking();
+   if (colorArea == 0) return;
+   float centX = width - (colorCentre.x+0.5)*G_DEF.DRAW_SCALE; // mirrored as drawTracking()
+   float centY = (colorCentre.y+0.5)*G_DEF.DRAW_SCALE;
+   pushStyle();
+   noStroke();
+   fill(0,255,0);
+   ellipse(centX, centY, 12, 12);
+   textAlign(LEFT, TOP);
+   text("area: "+colorArea+"  colour (c): "+G_DEF.COLOR_NAMES[colorPreset], 20, 50);
+   popStyle();
+}
+
+// ************************************************************
+//                      DRAW SIGNATURES
+// ************************************************************
+// The box of every signature found, in the colour of its preset,
+// mirrored as drawTracking().
+void drawSignatures() {
+   color[] shades = { color(255,0,0), color(0,255,0), color(0,0,255), color(255,255,0),
+                      color(255,0,255), color(0,255,255), color(255) };
+   float scale = G_DEF.DRAW_SCALE;
+   background(0);
+   pushStyle();
+   noFill();
+   strokeWeight(3);
+   for (int k = 0; k < G_DEF.SIG_MAX; k++) {
+      if (sigBox[k][4] == 0) continue;
+      stroke(shades[k]);
+      rect(width - (sigBox[k][2]+1)*scale, sigBox[k][1]*scale,
+           (sigBox[k][2]-sigBox[k][0]+1)*scale, (sigBox[k][3]-sigBox[k][1]+1)*scale);
+   }
+   popStyle();
+}
+
+// ************************************************************
+//                      SEND COLOUR WINDOW
+// ************************************************************
+void sendColorWindow(int preset) {
+      int[] win = G_DEF.COLOR_PRESETS[preset];
+      sendCommand(G_DEF.CMD_COLOR_U, 0, win[0] | (win[1] << 8));
+      sendCommand(G_DEF.CMD_COLOR_V, 0, win[2] | (win[3] << 8));
+      sendCommand(G_DEF.CMD_COLOR_Y, 0, win[4] | (win[5] << 8));
+}
+
 // ************************************************************
 //              CONVERT PIXEL STREAM BUFFER TO PIMAGE
 // ************************************************************
@@ -364,17 +959,74 @@ void buff2pixFrame(byte[][] pixBuff, PImage dstImg, request_t req) {
                           dstImg.pixels[l++] = ((Y0 & 0x01) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x02) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x04) == 0? 0:0xffffff);
-                          dstImg.pixels[l++] = ((Y0 & 0x05) == 0? 0:0xffffff);
+                          dstImg.pixels[l++] = ((Y0 & 0x08) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x10) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x20) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x40) == 0? 0:0xffffff);
                           dstImg.pixels[l++] = ((Y0 & 0x80) == 0? 0:0xffffff);
                        }
                        break;
+     case STREAMDECIM: for (int y = 0, l = 0; y < G_DEF.F_H; y++)
+                         for (int x = 0; x < G_DEF.F_W; x++)
+                            dstImg.pixels[l++] = color(int(pixBuff[y/frameDecim][x/frameDecim]));
+                       break;
+     case PROGRESSIVE: for (int y = 0, l = 0, src = 0; y < G_DEF.F_H; y++) {
+                         if (rowGot[y]) src = y; // rows not there yet repeat the nearest one above
+                         for (int x = 0; x < G_DEF.F_W; x++)
+                            dstImg.pixels[l++] = color(int(pixBuff[src][x]));
+                       }
+                       break;
+     case BITPLANES:   for (int y = 0, l = 0; y < G_DEF.F_H; y++)
+                         for (int x = 0; x < G_DEF.F_W; x++) // missing planes at mid range
+                            dstImg.pixels[l++] = color(planeY[y][x] | ((1 << lowestPlane) >> 1));
+                       break;
+     case ADAPTIVE:    if (frameEncoding != request_t.NONE) buff2pixFrame(pixBuff, dstImg, frameEncoding);
+                       break;
+     case EDGES:       buff2pixFrame(pixBuff, dstImg, request_t.STREAM8PPB); // same packings
+                       break;
+     case EDGES4:      buff2pixFrame(pixBuff, dstImg, request_t.STREAM2PPB);
+                       break;
+     case STREAM3BIT:  unpackBits(pixBuff, dstImg, 3); break;
+     case STREAM5BIT:  unpackBits(pixBuff, dstImg, 5); break;
   }
   dstImg.updatePixels();  
 }
   
+// ************************************************************
+//                 CONVERT STILL BUFFER TO PIMAGE
+// ************************************************************
+void buff2still(byte[][] pixBuff, PImage dstImg) {
+  int Y0 = 0, U = 0, Y1 = 0, V = 0;
+  
+  dstImg.loadPixels();
+  for (int y = 0, l = 0, x = 0; y < G_DEF.STILL_H; y++, x = 0)
+     while (x < G_DEF.STILL_W*G_DEF.BPP) {
+        Y0 = int(pixBuff[y][x++]);
+        U  = int(pixBuff[y][x++]);
+        Y1 = int(pixBuff[y][x++]);
+        V  = int(pixBuff[y][x++]);
+        dstImg.pixels[l++] = YUV2RGB(Y0,U,V);
+        dstImg.pixels[l++] = YUV2RGB(Y1,U,V);
+     }
+  dstImg.updatePixels();  
+}
+  
+// ************************************************************
+//                  UNPACK BIT STREAM ROWS
+// ************************************************************
+// Pixels packed LSB first in a continuous bit stream, possibly straddling
+// bytes (see fifo_readRowPacked in the firmware).
+void unpackBits(byte[][] pixBuff, PImage dstImg, int bits) {
+  int mask = (1 << bits) - 1;
+  for (int y = 0, l = 0; y < G_DEF.F_H; y++)
+     for (int x = 0, bitPos = 0; x < G_DEF.F_W; x++, bitPos += bits) {
+        int i = bitPos >> 3;
+        int word = (pixBuff[y][i] & 0xFF) | ((i+1 < G_DEF.MAX_ROW_LEN ? pixBuff[y][i+1] & 0xFF : 0) << 8);
+        int Y0 = (((word >> (bitPos & 7)) & mask) << (8 - bits)) | (0xFF >> (bits + 1));
+        dstImg.pixels[l++] = color(Y0);
+     }
+}
+  
 // ************************************************************
 //                     YUV TO RGB
 // ************************************************************
@@ -415,6 +1067,37 @@ void keyPressed() {
            break; 
    case 'k':  bKalmanEnabled = !bKalmanEnabled;
            break; 
+   case 'a':  bAutoExposure = !bAutoExposure;
+              sendCommand(G_DEF.CMD_AE, 0, bAutoExposure ? G_DEF.AE_TARGET : 0);
+           break; 
+   case 'h':  bHwRclk = !bHwRclk;
+              sendCommand(G_DEF.CMD_HWRCLK, 0, bHwRclk ? 0xFF : 0);
+           break; 
+   case 'H':  sendCommand(G_DEF.CMD_SEND, 0, G_DEF.SEND_HWCHECK); // "HWRCLK <sw> <hw> <bytes differing>"
+           break; 
+   case 'd':  decimFactor = (decimFactor >= 8) ? 1 : decimFactor*2;
+              sendCommand(G_DEF.CMD_DECIM, 0, decimFactor | (bDecimBox ? 0x100 : 0));
+           break; 
+   case 't':  for (int i = 0; i < TARGET_FPS_STEPS.length; i++)
+                 if (TARGET_FPS_STEPS[i] == targetFps) { targetFps = TARGET_FPS_STEPS[(i+1) % TARGET_FPS_STEPS.length]; break; }
+              sendCommand(G_DEF.CMD_TARGET_FPS, 0, targetFps);
+           break; 
+   case 'c':  colorPreset = (colorPreset+1) % G_DEF.COLOR_PRESETS.length;
+              sendColorWindow(colorPreset);
+           break; 
+   case 'm':  morphMode = (morphMode+1) % G_DEF.MORPH_NAMES.length;
+              sendCommand(G_DEF.CMD_MORPH, 0, morphMode);
+           break; 
+   case 'p':  planeDepth = (planeDepth % (8 - G_DEF.PLANE_LOWEST)) + 1;
+           break; 
+   case 'b':  bDecimBox = !bDecimBox;
+              sendCommand(G_DEF.CMD_DECIM, 0, decimFactor | (bDecimBox ? 0x100 : 0));
+           break; 
+   case 'r':  rateProfile = (rateProfile+1) % G_DEF.N_RATE_PROFILES;
+              serialPort.clear();
+              reqStatus = requestStatus_t.IDLE;
+              sendCommand(G_DEF.CMD_RATE, 0, rateProfile); // replies the achieved fps
+           break; 
    case '+':  thresh++;
            break; 
    case '-':  thresh--;